@@ -0,0 +1,540 @@
+/**
+ * FinCraftr benchmark suite
+ *
+ * Times every function in equity/, options/, forwards/ and rates/, and both fc::math
+ * policies under math/, at scalar and batch
+ * sizes and reports nanoseconds per element (median and percentiles over repeated samples).
+ * When built against the compiled library (FINCRAFTR_HEADER_ONLY=OFF) the ISA-dispatched
+ * kernels of core/kernels.hpp are timed as well, under kernels/.
+ *
+ * Build: cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DFINCRAFTR_BUILD_BENCHMARKS=ON
+ *        cmake --build build --target fincraftr_bench
+ *
+ * Usage: fincraftr_bench [--filter SUBSTR] [--sizes 1,1000,100000] [--repetitions N]
+ *                        [--warmup-ms MS] [--min-sample-ms MS] [--json FILE|-]
+ *                        [--compare BASELINE.json] [--threshold FRACTION] [--counters] [--list]
+ *
+ * --counters reads cycles, instructions, LLC misses and branch misses with perf_event_open
+ * around each measurement and adds IPC and events per element to the table and JSON. Where
+ * the kernel refuses (containers, perf_event_paranoid, non-Linux) a note is printed and the
+ * run continues with timings only.
+ *
+ * --compare exits with status 1 if any median is slower than the baseline by more than
+ * --threshold (default 0.10), so a stored baseline can gate a release.
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fincraftr/core/instrument.hpp>
+#include <fincraftr/core/math.hpp>
+#include <fincraftr/equity/attribution.hpp>
+#include <fincraftr/equity/basic.hpp>
+#include <fincraftr/equity/dcf.hpp>
+#include <fincraftr/equity/index.hpp>
+#include <fincraftr/equity/ownership.hpp>
+#include <fincraftr/equity/pnl_book.hpp>
+#include <fincraftr/equity/profit.hpp>
+#include <fincraftr/equity/returns.hpp>
+#include <fincraftr/equity/valuation.hpp>
+#include <fincraftr/forwards/pricing.hpp>
+#include <fincraftr/options/binomial.hpp>
+#include <fincraftr/options/parity.hpp>
+#include <fincraftr/options/payoff.hpp>
+#include <fincraftr/options/profit.hpp>
+#include <fincraftr/rates/compounding.hpp>
+#include <fincraftr/rates/conversions.hpp>
+#include <fincraftr/rates/discount.hpp>
+
+#ifdef FINCRAFTR_BENCH_KERNELS
+#include <fincraftr/core/kernels.hpp>
+#endif
+
+#include "harness.hpp"
+
+#ifndef FINCRAFTR_VERSION
+#define FINCRAFTR_VERSION "unknown"
+#endif
+
+namespace {
+    using fc::bench::kernel;
+
+    struct range {
+        double lo, hi;
+    };
+
+    // Fixed seeds so every run and every build sees the same inputs
+    std::vector<double> uniform(std::size_t n, range r, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> dist(r.lo, r.hi);
+        std::vector<double> v(n);
+        for (double& x : v) x = dist(rng);
+        return v;
+    }
+
+    template <class F, std::size_t N, std::size_t... I>
+    void apply_batch(const F& f, const std::array<std::vector<double>, N>& in, double* out, std::size_t n,
+                     std::index_sequence<I...>) {
+        const std::array<const double*, N> p{in[I].data()...};
+        for (std::size_t i = 0; i < n; ++i) out[i] = static_cast<double>(f(p[I][i]...));
+    }
+
+    // out[i] = f(in_0[i], ..., in_{N-1}[i]) over batches of n random inputs
+    template <std::size_t N, class F>
+    fc::bench::factory elementwise(F f, std::array<range, N> ranges) {
+        return [f, ranges](std::size_t n) -> kernel {
+            std::array<std::vector<double>, N> in;
+            for (std::size_t k = 0; k < N; ++k) in[k] = uniform(n, ranges[k], k + 1);
+            return [f, in, out = std::vector<double>(n)](std::size_t iterations) mutable {
+                double* dst = out.data();
+                fc::bench::do_not_optimize(dst);
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    apply_batch(f, in, dst, out.size(), std::make_index_sequence<N>{});
+                    fc::bench::clobber_memory();
+                }
+            };
+        };
+    }
+
+    // Reduction over a column of n values: sink = f(column)
+    template <class F>
+    fc::bench::factory sequence(F f, range r, std::size_t columns = 1) {
+        return [f, r, columns](std::size_t n) -> kernel {
+            std::vector<std::vector<double>> in;
+            for (std::size_t k = 0; k < columns; ++k) in.push_back(uniform(n, r, k + 1));
+            return [f, in](std::size_t iterations) {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    double sink = f(in);
+                    fc::bench::do_not_optimize(sink);
+                    fc::bench::clobber_memory();
+                }
+            };
+        };
+    }
+
+#ifdef FINCRAFTR_BENCH_KERNELS
+    template <class T, std::size_t N, class K, std::size_t... I>
+    void call_kernel(K k, std::size_t n, const std::array<std::vector<T>, N>& in, T* out,
+                     std::index_sequence<I...>) {
+        k(n, in[I].data()..., out);
+    }
+
+    template <class T, std::size_t N>
+    std::array<std::vector<T>, N> kernel_inputs(std::size_t n, const std::array<range, N>& ranges) {
+        std::array<std::vector<T>, N> in;
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::vector<double> v = uniform(n, ranges[i], i + 1);
+            in[i].assign(v.begin(), v.end());
+        }
+        return in;
+    }
+
+    // Out-of-line kernel from the compiled library over batches of n random inputs
+    // (T = float for the fc::kernels::f32 kernels)
+    template <std::size_t N, class T = double, class K>
+    fc::bench::factory compiled(K k, std::array<range, N> ranges) {
+        return [k, ranges](std::size_t n) -> kernel {
+            return [k, in = kernel_inputs<T>(n, ranges), out = std::vector<T>(n)](std::size_t iterations) mutable {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    call_kernel(k, out.size(), in, out.data(), std::make_index_sequence<N>{});
+                    fc::bench::clobber_memory();
+                }
+            };
+        };
+    }
+
+    template <std::size_t N, class K, std::size_t... I>
+    double call_sum_kernel(K k, const std::array<std::vector<float>, N>& in, std::index_sequence<I...>) {
+        return k(in[0].size(), in[I].data()...);
+    }
+
+    // Single-precision *_sum kernel over batches of n random inputs
+    template <std::size_t N, class K>
+    fc::bench::factory compiled_sum(K k, std::array<range, N> ranges) {
+        return [k, ranges](std::size_t n) -> kernel {
+            return [k, in = kernel_inputs<float>(n, ranges)](std::size_t iterations) {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    double sink = call_sum_kernel(k, in, std::make_index_sequence<N>{});
+                    fc::bench::do_not_optimize(sink);
+                    fc::bench::clobber_memory();
+                }
+            };
+        };
+    }
+
+    void register_kernels(fc::bench::suite& s) {
+        using namespace fc::kernels;
+        s.add("kernels/market_cap", compiled<2>(&market_cap, {{{1e6, 1e9}, {1, 500}}}));
+        s.add("kernels/ownership_fraction", compiled<2>(&ownership_fraction, {{{0, 1e6}, {1e6, 1e9}}}));
+        s.add("kernels/return_simple", compiled<2>(&return_simple, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/profit_simple", compiled<4>(&profit_simple, {{{50, 150}, {50, 150}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/profit_with_costs", compiled<6>(&profit_with_costs,
+            {{{50, 150}, {50, 150}, {0, 0.1}, {0, 2}, {0, 5}, {50, 150}}}));
+        s.add("kernels/ddm_single_period", compiled<3>(&ddm_single_period, {{{0, 5}, {50, 150}, {0.02, 0.12}}}));
+        s.add("kernels/cost_of_equity", compiled<3>(&cost_of_equity, {{{0, 5}, {50, 150}, {50, 150}}}));
+        s.add("kernels/ddm_gordon_growth", compiled<3>(&ddm_gordon_growth, {{{0, 5}, {0.08, 0.12}, {0, 0.06}}}));
+        s.add("kernels/payoff_call", compiled<2>(&payoff_call, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/payoff_put", compiled<2>(&payoff_put, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/payoff_asian_call", compiled<2>(&payoff_asian_call, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/profit_call", compiled<5>(&profit_call, {{{50, 150}, {50, 150}, {0, 10}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/hedge_ratio_binomial", compiled<4>(&hedge_ratio_binomial,
+            {{{10, 30}, {0, 5}, {110, 130}, {70, 90}}}));
+        s.add("kernels/loan_binomial", compiled<5>(&loan_binomial, {{{10, 30}, {0, 5}, {110, 130}, {70, 90}, {0, 0.1}}}));
+        s.add("kernels/price_binomial_one_period", compiled<5>(&price_binomial_one_period,
+            {{{50, 150}, {0, 1}, {0, 50}, {0, 0.1}, {0.5, 2}}}));
+        s.add("kernels/price_risk_neutral_one_period", compiled<7>(&price_risk_neutral_one_period,
+            {{{95, 105}, {110, 130}, {70, 90}, {10, 30}, {0, 5}, {0, 0.1}, {0.5, 2}}}));
+        s.add("kernels/forward_price_no_div", compiled<3>(&forward_price_no_div, {{{50, 150}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/forward_price_with_div", compiled<4>(&forward_price_with_div,
+            {{{50, 150}, {0, 5}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/forward_price_cont_yield", compiled<4>(&forward_price_cont_yield,
+            {{{50, 150}, {0, 0.1}, {0, 0.05}, {0, 2}}}));
+        s.add("kernels/compound_discrete", compiled<4>(&compound_discrete, {{{100, 1e4}, {0, 0.1}, {12, 12}, {0, 30}}}));
+        s.add("kernels/compound_continuous", compiled<3>(&compound_continuous, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/roll_forward_cont", compiled<3>(&roll_forward_cont, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/roll_back_cont", compiled<3>(&roll_back_cont, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/nominal_to_continuous", compiled<2>(&nominal_to_continuous, {{{0, 0.1}, {1, 12}}}));
+        s.add("kernels/continuous_to_nominal", compiled<2>(&continuous_to_nominal, {{{0, 0.1}, {1, 12}}}));
+
+        namespace f32 = fc::kernels::f32;
+        s.add("kernels/f32/roll_back_cont", compiled<3, float>(&f32::roll_back_cont, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/f32/roll_forward_cont", compiled<3, float>(&f32::roll_forward_cont,
+            {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/f32/compound_continuous", compiled<3, float>(&f32::compound_continuous,
+            {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/f32/roll_back_cont_sum", compiled_sum<3>(&f32::roll_back_cont_sum,
+            {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("kernels/f32/forward_price_no_div", compiled<3, float>(&f32::forward_price_no_div,
+            {{{50, 150}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/f32/forward_price_with_div", compiled<4, float>(&f32::forward_price_with_div,
+            {{{50, 150}, {0, 5}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/f32/forward_price_cont_yield", compiled<4, float>(&f32::forward_price_cont_yield,
+            {{{50, 150}, {0, 0.1}, {0, 0.05}, {0, 2}}}));
+        s.add("kernels/f32/payoff_call", compiled<2, float>(&f32::payoff_call, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/f32/payoff_put", compiled<2, float>(&f32::payoff_put, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/f32/payoff_asian_call", compiled<2, float>(&f32::payoff_asian_call, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/f32/profit_call", compiled<5, float>(&f32::profit_call,
+            {{{50, 150}, {50, 150}, {0, 10}, {0, 0.1}, {0, 2}}}));
+        s.add("kernels/f32/payoff_call_sum", compiled_sum<2>(&f32::payoff_call_sum, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/f32/payoff_put_sum", compiled_sum<2>(&f32::payoff_put_sum, {{{50, 150}, {50, 150}}}));
+        s.add("kernels/f32/hedge_ratio_binomial", compiled<4, float>(&f32::hedge_ratio_binomial,
+            {{{10, 30}, {0, 5}, {110, 130}, {70, 90}}}));
+        s.add("kernels/f32/price_risk_neutral_one_period", compiled<7, float>(&f32::price_risk_neutral_one_period,
+            {{{95, 105}, {110, 130}, {70, 90}, {10, 30}, {0, 5}, {0, 0.1}, {0.5, 2}}}));
+    }
+#endif
+
+    void register_equity(fc::bench::suite& s) {
+        using namespace fc::equity;
+        s.add("equity/market_cap", elementwise<2>(&market_cap, {{{1e6, 1e9}, {1, 500}}}));
+        s.add("equity/ownership_fraction", elementwise<2>(&ownership_fraction<>, {{{0, 1e6}, {1e6, 1e9}}}));
+        s.add("equity/return_simple", elementwise<2>(&return_simple<>, {{{50, 150}, {50, 150}}}));
+        s.add("equity/profit_simple", elementwise<4>(&profit_simple<>, {{{50, 150}, {50, 150}, {0, 0.1}, {0, 2}}}));
+        s.add("equity/profit_with_costs", elementwise<6>(&profit_with_costs<>,
+            {{{50, 150}, {50, 150}, {0, 0.1}, {0, 2}, {0, 5}, {50, 150}}}));
+        s.add("equity/ddm_single_period", elementwise<3>(&ddm_single_period, {{{0, 5}, {50, 150}, {0.02, 0.12}}}));
+        s.add("equity/cost_of_equity", elementwise<3>(&cost_of_equity<>, {{{0, 5}, {50, 150}, {50, 150}}}));
+        s.add("equity/ddm_gordon_growth", elementwise<3>(&ddm_gordon_growth<>, {{{0, 5}, {0.08, 0.12}, {0, 0.06}}}));
+        s.add("equity/dcf_two_stage", elementwise<5>(
+            [](double revenue, double margin, double g, double g_terminal, double r) {
+                return dcf_two_stage(revenue, margin, g, g_terminal, r, 5);
+            },
+            {{{1e3, 1e5}, {0.05, 0.3}, {0, 0.1}, {0, 0.03}, {0.06, 0.12}}}));
+
+        auto span = [](const std::vector<double>& v) { return std::span<const double>(v); };
+        s.add("equity/index_price_weighted", sequence([=](const auto& in) {
+            return index_price_weighted(span(in[0]), 10.0);
+        }, {10, 500}));
+        s.add("equity/index_cap_weighted", sequence([=](const auto& in) {
+            return index_cap_weighted(100.0, span(in[0]), span(in[1]));
+        }, {1e6, 1e9}, 2));
+        s.add("equity/index_value_line_geo", sequence([=](const auto& in) {
+            return index_value_line_geo(100.0, span(in[0]), span(in[1]));
+        }, {10, 500}, 2));
+        s.add("equity/index_value_line_arith", sequence([=](const auto& in) {
+            return index_value_line_arith(100.0, span(in[0]), span(in[1]));
+        }, {10, 500}, 2));
+        s.add("equity/ddm_multi_period", sequence([=](const auto& in) {
+            return ddm_multi_period(span(in[0]), 100.0, 0.08);
+        }, {0, 5}));
+        s.add("equity/ddm_infinite", sequence([=](const auto& in) {
+            return ddm_infinite(span(in[0]), 0.08);
+        }, {0, 5}));
+
+        s.add("equity/returns_simple", [](std::size_t n) -> kernel {
+            return [now = uniform(n, {50, 150}, 1), prev = uniform(n, {50, 150}, 2),
+                    out = std::vector<double>(n)](std::size_t iterations) mutable {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    returns_simple(now, prev, out);
+                    fc::bench::clobber_memory();
+                }
+            };
+        });
+
+        // Attribution: size = securities, 11 sectors
+        auto holdings = [](std::size_t n, std::uint64_t seed) {
+            struct columns {
+                std::vector<double> wp, wb, r;
+                std::vector<std::uint32_t> sectors;
+            } c{uniform(n, {0, 1}, seed), uniform(n, {0, 1}, seed + 1), uniform(n, {-0.1, 0.1}, seed + 2), {}};
+            std::mt19937_64 rng(seed + 3);
+            for (std::size_t i = 0; i < n; ++i) c.sectors.push_back(static_cast<std::uint32_t>(rng() % 11));
+            return c;
+        };
+        s.add("equity/brinson_fachler", [=](std::size_t n) -> kernel {
+            auto c = std::make_shared<decltype(holdings(0, 0))>(holdings(n, 1));
+            return [c](std::size_t iterations) {
+                const AttributionHoldings h{c->wp, c->wb, c->r, c->sectors};
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    BrinsonAttribution a = brinson_fachler(h, 11);
+                    fc::bench::do_not_optimize(a.total_allocation);
+                }
+            };
+        });
+        s.add("equity/brinson_fachler_batch", {32000, 3200000}, [=](std::size_t n) -> kernel {
+            using cols = decltype(holdings(0, 0));
+            auto data = std::make_shared<std::vector<cols>>();
+            for (std::uint64_t p = 0; p < 32; ++p) data->push_back(holdings(n / 32, 4 * p + 1));
+            return [data](std::size_t iterations) {
+                std::vector<AttributionHoldings> hs;
+                for (const cols& c : *data) hs.push_back({c.wp, c.wb, c.r, c.sectors});
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    auto a = brinson_fachler_batch(hs, 11, 0);
+                    fc::bench::do_not_optimize(a);
+                }
+            };
+        });
+
+        // Monte Carlo DCF: size = scenarios for one company, single-threaded
+        s.add("equity/dcf_monte_carlo", {1000, 100000}, [](std::size_t n) -> kernel {
+            DcfCompany company;
+            company.revenue = 1e4;
+            company.mean = {0.05, 0.02, 0.15, 0.09};
+            company.vol = {0.02, 0.005, 0.03, 0.01};
+            DcfMonteCarloConfig config;
+            config.scenarios = n;
+            config.threads = 1;
+            return [companies = std::vector<DcfCompany>{company}, config](std::size_t iterations) {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    auto d = dcf_monte_carlo(companies, config);
+                    fc::bench::do_not_optimize(d);
+                }
+            };
+        });
+
+        // Look-through ownership: size = entities, about four holdings each, single-threaded
+        s.add("equity/ownership_look_through", {1000, 100000}, [](std::size_t n) -> kernel {
+            std::mt19937_64 rng(7);
+            std::vector<Shareholding> holdings;
+            for (std::uint32_t investee = 0; investee < n; ++investee)
+                for (int k = 0; k < 4; ++k)
+                    holdings.push_back({static_cast<std::uint32_t>(rng() % n), investee, 1.0 + static_cast<double>(rng() % 10), 100.0});
+            auto graph = std::make_shared<OwnershipGraph>(n, holdings);
+            LookThroughOptions options;
+            options.threads = 1;
+            return [graph, options](std::size_t iterations) {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    LookThroughResult r = graph->look_through(0, options);
+                    fc::bench::do_not_optimize(r);
+                }
+            };
+        });
+
+        // Position book tick: size = lots on the ticking instrument, spread over 8 desks
+        s.add("equity/pnl_book_on_tick", [](std::size_t n) -> kernel {
+            std::vector<PnlLot> lots;
+            std::mt19937_64 rng(11);
+            for (std::size_t i = 0; i < n; ++i)
+                lots.push_back({0, static_cast<std::uint32_t>(rng() % 8), 100.0, 100.0, 0.05, 0.5, 1.0, 100.0});
+            auto book = std::make_shared<PnlBook>(lots, 1, 8);
+            return [book](std::size_t iterations) {
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    double delta = book->on_tick(0, 100.0 + static_cast<double>(it & 7));
+                    fc::bench::do_not_optimize(delta);
+                }
+            };
+        });
+    }
+
+    void register_options(fc::bench::suite& s) {
+        using namespace fc::options;
+        s.add("options/payoff_call", elementwise<2>(&payoff_call, {{{50, 150}, {50, 150}}}));
+        s.add("options/payoff_put", elementwise<2>(&payoff_put, {{{50, 150}, {50, 150}}}));
+        s.add("options/payoff_asian_call", elementwise<2>(&payoff_asian_call, {{{50, 150}, {50, 150}}}));
+        s.add("options/profit_call", elementwise<5>(&profit_call<>, {{{50, 150}, {50, 150}, {0, 10}, {0, 0.1}, {0, 2}}}));
+        s.add("options/payoff_binomial_call", elementwise<3>([](double Su, double Sd, double K) {
+            auto [Cu, Cd] = payoff_binomial_call(Su, Sd, K);
+            return Cu + Cd;
+        }, {{{110, 130}, {70, 90}, {80, 120}}}));
+        s.add("options/hedge_ratio_binomial", elementwise<4>(&hedge_ratio_binomial,
+            {{{10, 30}, {0, 5}, {110, 130}, {70, 90}}}));
+        s.add("options/loan_binomial", elementwise<5>(&loan_binomial,
+            {{{10, 30}, {0, 5}, {110, 130}, {70, 90}, {0, 0.1}}}));
+        s.add("options/price_binomial_one_period", elementwise<5>(&price_binomial_one_period<>,
+            {{{50, 150}, {0, 1}, {0, 50}, {0, 0.1}, {0.5, 2}}}));
+        s.add("options/price_risk_neutral_one_period", elementwise<7>(&price_risk_neutral_one_period<>,
+            {{{95, 105}, {110, 130}, {70, 90}, {10, 30}, {0, 5}, {0, 0.1}, {0.5, 2}}}));
+        s.add("options/check_put_call_parity", elementwise<6>([](double C, double P, double S, double K, double r, double tau) {
+            return check_put_call_parity(C, P, S, K, r, tau);
+        }, {{{0, 20}, {0, 20}, {50, 150}, {50, 150}, {0, 0.1}, {0, 2}}}));
+    }
+
+    void register_forwards(fc::bench::suite& s) {
+        using namespace fc::forwards;
+        s.add("forwards/forward_price_no_div", elementwise<3>(&forward_price_no_div<>, {{{50, 150}, {0, 0.1}, {0, 2}}}));
+        s.add("forwards/forward_price_with_div", elementwise<4>(&forward_price_with_div<>,
+            {{{50, 150}, {0, 5}, {0, 0.1}, {0, 2}}}));
+        s.add("forwards/forward_price_cont_yield", elementwise<4>(&forward_price_cont_yield<>,
+            {{{50, 150}, {0, 0.1}, {0, 0.05}, {0, 2}}}));
+    }
+
+    void register_rates(fc::bench::suite& s) {
+        using namespace fc::rates;
+        s.add("rates/compound_discrete", elementwise<3>([](double p0, double r, double years) {
+            return compound_discrete(p0, r, 12, years);
+        }, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("rates/compound_continuous", elementwise<3>(&compound_continuous<>, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("rates/roll_forward_cont", elementwise<3>(&roll_forward_cont<>, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("rates/roll_back_cont", elementwise<3>(&roll_back_cont<>, {{{100, 1e4}, {0, 0.1}, {0, 30}}}));
+        s.add("rates/nominal_to_continuous", elementwise<2>(&nominal_to_continuous<>, {{{0, 0.1}, {1, 12}}}));
+        s.add("rates/continuous_to_nominal", elementwise<2>(&continuous_to_nominal<>, {{{0, 0.1}, {1, 12}}}));
+    }
+
+    void register_math(fc::bench::suite& s) {
+        using fc::math::exact;
+        using fc::math::fast;
+        s.add("math/exp", elementwise<1>(&fc::math::exp<exact>, {{{-5, 5}}}));
+        s.add("math/exp_fast", elementwise<1>(&fc::math::exp<fast>, {{{-5, 5}}}));
+        s.add("math/expm1", elementwise<1>(&fc::math::expm1<exact>, {{{-1, 1}}}));
+        s.add("math/expm1_fast", elementwise<1>(&fc::math::expm1<fast>, {{{-1, 1}}}));
+        s.add("math/log", elementwise<1>(&fc::math::log<exact>, {{{1e-3, 1e3}}}));
+        s.add("math/log_fast", elementwise<1>(&fc::math::log<fast>, {{{1e-3, 1e3}}}));
+        s.add("math/log1p", elementwise<1>(&fc::math::log1p<exact>, {{{-0.5, 1}}}));
+        s.add("math/log1p_fast", elementwise<1>(&fc::math::log1p<fast>, {{{-0.5, 1}}}));
+        s.add("math/pow", elementwise<2>(&fc::math::pow<exact>, {{{0.9, 1.1}, {0, 30}}}));
+        s.add("math/pow_fast", elementwise<2>(&fc::math::pow<fast>, {{{0.9, 1.1}, {0, 30}}}));
+    }
+
+    std::vector<std::size_t> parse_sizes(const std::string& text) {
+        std::vector<std::size_t> sizes;
+        for (std::size_t b = 0; b < text.size();) {
+            std::size_t e = text.find(',', b);
+            if (e == std::string::npos) e = text.size();
+            sizes.push_back(std::strtoull(text.substr(b, e - b).c_str(), nullptr, 10));
+            b = e + 1;
+        }
+        return sizes;
+    }
+
+    int usage(const char* argv0) {
+        std::fprintf(stderr,
+            "usage: %s [--filter SUBSTR] [--sizes 1,1000,100000] [--repetitions N] [--warmup-ms MS]\n"
+            "          [--min-sample-ms MS] [--json FILE|-] [--compare BASELINE.json] [--threshold FRACTION]\n"
+            "          [--counters] [--list]\n", argv0);
+        return 2;
+    }
+}
+
+int main(int argc, char** argv) {
+    fc::bench::options opt;
+    std::string json_path, baseline_path;
+    double threshold = 0.10;
+    bool list = false, counters = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--list") list = true;
+        else if (arg == "--counters") counters = true;
+        else if (arg == "--filter" && has_value) opt.filter = argv[++i];
+        else if (arg == "--sizes" && has_value) opt.sizes = parse_sizes(argv[++i]);
+        else if (arg == "--repetitions" && has_value) opt.repetitions = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--warmup-ms" && has_value) opt.warmup_ms = std::strtod(argv[++i], nullptr);
+        else if (arg == "--min-sample-ms" && has_value) opt.min_sample_ms = std::strtod(argv[++i], nullptr);
+        else if (arg == "--json" && has_value) json_path = argv[++i];
+        else if (arg == "--compare" && has_value) baseline_path = argv[++i];
+        else if (arg == "--threshold" && has_value) threshold = std::strtod(argv[++i], nullptr);
+        else return usage(argv[0]);
+    }
+
+    fc::bench::suite suite;
+    register_equity(suite);
+    register_options(suite);
+    register_forwards(suite);
+    register_rates(suite);
+    register_math(suite);
+#ifdef FINCRAFTR_BENCH_KERNELS
+    register_kernels(suite);
+    std::fprintf(stderr, "compiled kernels dispatched to: %s\n", fc::kernels::isa());
+#endif
+
+    if (list) {
+        for (const std::string& name : suite.names()) std::printf("%s\n", name.c_str());
+        return 0;
+    }
+
+    std::vector<fc::bench::baseline_entry> baseline;
+    if (!baseline_path.empty()) {
+        baseline = fc::bench::read_baseline(baseline_path);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "no benchmarks found in baseline %s\n", baseline_path.c_str());
+            return 2;
+        }
+    }
+
+    std::unique_ptr<fc::bench::perf_counters> perf;
+    if (counters) {
+        perf = std::make_unique<fc::bench::perf_counters>();
+        if (!perf->error().empty())
+            std::fprintf(stderr, "hardware counters %s: %s\n", perf->available() ? "partly unavailable" : "unavailable",
+                         perf->error().c_str());
+        if (perf->available()) opt.counters = perf.get();
+    }
+
+    // With --json - the table goes to stderr so stdout stays valid JSON
+    FILE* table = json_path == "-" ? stderr : stdout;
+    std::fprintf(table, "%-44s %10s %12s %12s %12s %12s %12s", "benchmark", "size", "median ns", "p10 ns", "p90 ns",
+                 "p99 ns", "Melem/s");
+    if (opt.counters) std::fprintf(table, " %8s %10s %10s %10s", "IPC", "cyc/elem", "LLC/elem", "brmis/elem");
+    std::fprintf(table, "\n");
+    const auto results = suite.run(opt, [&](const fc::bench::result& r) {
+        std::fprintf(table, "%-44s %10zu %12.3f %12.3f %12.3f %12.3f %12.1f", r.name.c_str(), r.size,
+                     r.median, r.p10, r.p90, r.p99, 1e3 / r.median);
+        if (opt.counters) {
+            using fc::bench::counter;
+            std::fprintf(table, " %8.2f %10.3f %10.4f %10.4f", r.ipc(), r.per_element[counter::cycles],
+                         r.per_element[counter::llc_misses], r.per_element[counter::branch_misses]);
+        }
+        std::fprintf(table, "\n");
+        std::fflush(table);
+    });
+    if constexpr (fc::instrument::enabled) std::fprintf(table, "\n%s", fc::instrument::report().c_str());
+
+    if (json_path == "-") {
+        fc::bench::write_json(std::cout, results, opt, FINCRAFTR_VERSION);
+    } else if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        fc::bench::write_json(out, results, opt, FINCRAFTR_VERSION);
+        if (!out) {
+            std::fprintf(stderr, "could not write %s\n", json_path.c_str());
+            return 2;
+        }
+    }
+
+    if (!baseline.empty()) {
+        std::fprintf(table, "\n");
+        const std::size_t regressions = fc::bench::compare(results, baseline, threshold, table);
+        std::fprintf(table, "%zu regression(s) above %.1f%%\n", regressions, 100.0 * threshold);
+        return regressions == 0 ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+namespace fc::bench {
+    /// Keep a value alive and opaque so the optimizer cannot delete or hoist its computation
+    template <class T>
+    inline void do_not_optimize(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : "+m"(value) : : "memory");
+#else
+        static_cast<void>(*static_cast<volatile T*>(&value));
+#endif
+    }
+
+    /// Compiler barrier: memory written before it must really be written
+    inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    /// Runs one batch of `size` elements `iterations` times
+    using kernel = std::function<void(std::size_t iterations)>;
+
+    /// Builds the kernel for a batch size; setup inside it is not timed
+    using factory = std::function<kernel(std::size_t size)>;
+
+    /// Measurement settings
+    struct options {
+        std::vector<std::size_t> sizes{1, 1000, 100000}; ///< Batch sizes for elementwise benchmarks
+        unsigned repetitions = 25;  ///< Timed samples per benchmark
+        double warmup_ms = 20.0;    ///< Untimed running before the first sample
+        double min_sample_ms = 2.0; ///< Iterations per sample are doubled until a sample takes this long
+        std::string filter;         ///< Only run benchmarks whose name contains this
+        perf_counters* counters = nullptr; ///< Hardware counters read around the timed samples
+    };
+
+    /// Timing of one benchmark at one size; times are nanoseconds per element
+    struct result {
+        std::string name;
+        std::size_t size = 0;
+        std::size_t iterations = 0; ///< Batches per sample
+        std::vector<double> samples;
+        double median = 0.0, mean = 0.0, min = 0.0, p10 = 0.0, p90 = 0.0, p99 = 0.0;
+        counter_values per_element; ///< Hardware events per element over all samples (NaN if unavailable)
+
+        /// @return Instructions per cycle (NaN if either counter is unavailable)
+        double ipc() const { return per_element[counter::instructions] / per_element[counter::cycles]; }
+    };
+
+    /// @param sorted Ascending samples (non-empty)
+    /// @param p Percentile in [0, 100]
+    /// @return Linearly interpolated percentile
+    inline double percentile(const std::vector<double>& sorted, double p) {
+        const double pos = p / 100.0 * static_cast<double>(sorted.size() - 1);
+        const std::size_t lo = static_cast<std::size_t>(pos);
+        const std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (pos - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+    }
+
+    /// Time a kernel: warm up, calibrate the iteration count, then take repetitions samples
+    inline result measure(const std::string& name, std::size_t size, const kernel& run, const options& opt) {
+        using clock = std::chrono::steady_clock;
+        auto elapsed_ns = [](clock::time_point t0) {
+            return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        };
+
+        const double warmup_ns = opt.warmup_ms * 1e6, sample_ns = opt.min_sample_ms * 1e6;
+        const auto warmup_start = clock::now();
+        do run(1); while (elapsed_ns(warmup_start) < warmup_ns);
+
+        std::size_t iterations = 1;
+        for (;;) {
+            const auto t0 = clock::now();
+            run(iterations);
+            if (elapsed_ns(t0) >= sample_ns || iterations >= (std::size_t{1} << 40)) break;
+            iterations *= 2;
+        }
+
+        result r;
+        r.name = name;
+        r.size = size;
+        r.iterations = iterations;
+        const double elements = static_cast<double>(iterations) * static_cast<double>(size == 0 ? 1 : size);
+        const unsigned repetitions = std::max(1u, opt.repetitions);
+        const bool counting = opt.counters && opt.counters->available();
+        if (counting) opt.counters->start();
+        for (unsigned k = 0; k < repetitions; ++k) {
+            const auto t0 = clock::now();
+            run(iterations);
+            r.samples.push_back(elapsed_ns(t0) / elements);
+        }
+        if (counting) {
+            r.per_element = opt.counters->stop();
+            for (double& v : r.per_element.value) v /= elements * repetitions;
+        }
+
+        std::vector<double> sorted = r.samples;
+        std::sort(sorted.begin(), sorted.end());
+        r.median = percentile(sorted, 50.0);
+        r.p10 = percentile(sorted, 10.0);
+        r.p90 = percentile(sorted, 90.0);
+        r.p99 = percentile(sorted, 99.0);
+        r.min = sorted.front();
+        double sum = 0.0;
+        for (double s : sorted) sum += s;
+        r.mean = sum / static_cast<double>(sorted.size());
+        return r;
+    }
+
+    /// Registry of benchmarks, each run at a list of batch sizes
+    class suite {
+    public:
+        /// Register a benchmark run at every size in options::sizes
+        void add(std::string name, factory make) { entries_.push_back({std::move(name), std::move(make), {}}); }
+
+        /// Register a benchmark run at fixed sizes (for engines whose size means something else)
+        void add(std::string name, std::vector<std::size_t> sizes, factory make) {
+            entries_.push_back({std::move(name), std::move(make), std::move(sizes)});
+        }
+
+        /// @return Registered benchmark names
+        std::vector<std::string> names() const {
+            std::vector<std::string> out;
+            for (const entry& e : entries_) out.push_back(e.name);
+            return out;
+        }
+
+        /// Run every benchmark matching options::filter
+        /// @param progress Called with each result as soon as it is measured
+        std::vector<result> run(const options& opt, const std::function<void(const result&)>& progress = {}) const {
+            std::vector<result> out;
+            for (const entry& e : entries_) {
+                if (!opt.filter.empty() && e.name.find(opt.filter) == std::string::npos) continue;
+                for (std::size_t size : e.sizes.empty() ? opt.sizes : e.sizes) {
+                    kernel k = e.make(size);
+                    out.push_back(measure(e.name, size, k, opt));
+                    if (progress) progress(out.back());
+                }
+            }
+            return out;
+        }
+
+    private:
+        struct entry {
+            std::string name;
+            factory make;
+            std::vector<std::size_t> sizes;
+        };
+        std::vector<entry> entries_;
+    };
+
+    /// Write results as JSON, one benchmark object per line
+    inline void write_json(std::ostream& os, const std::vector<result>& results, const options& opt,
+                           const std::string& version) {
+        os << "{\n  \"fincraftr_version\": \"" << version << "\",\n"
+           << "  \"repetitions\": " << opt.repetitions << ",\n"
+           << "  \"unit\": \"ns_per_element\",\n"
+           << "  \"benchmarks\": [\n";
+        char line[512];
+        for (std::size_t k = 0; k < results.size(); ++k) {
+            const result& r = results[k];
+            std::snprintf(line, sizeof(line),
+                "    {\"name\": \"%s\", \"size\": %zu, \"iterations\": %zu, \"median_ns\": %.6g, "
+                "\"mean_ns\": %.6g, \"min_ns\": %.6g, \"p10_ns\": %.6g, \"p90_ns\": %.6g, \"p99_ns\": %.6g",
+                r.name.c_str(), r.size, r.iterations, r.median, r.mean, r.min, r.p10, r.p90, r.p99);
+            os << line;
+            // Counters that were not measured are left out rather than written as NaN (not JSON)
+            for (std::size_t c = 0; c < counter_count; ++c) {
+                if (std::isnan(r.per_element.value[c])) continue;
+                std::snprintf(line, sizeof(line), ", \"%s_per_element\": %.6g", counter_names[c], r.per_element.value[c]);
+                os << line;
+            }
+            if (!std::isnan(r.ipc())) {
+                std::snprintf(line, sizeof(line), ", \"ipc\": %.4g", r.ipc());
+                os << line;
+            }
+            os << "}" << (k + 1 < results.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+
+    /// Baseline entry read back from a file written by write_json
+    struct baseline_entry {
+        std::string name;
+        std::size_t size = 0;
+        double median = 0.0;
+    };
+
+    /// Read the name, size and median of every benchmark line of a write_json file
+    /// @return Entries, or an empty vector if the file cannot be read
+    inline std::vector<baseline_entry> read_baseline(const std::string& path) {
+        std::vector<baseline_entry> out;
+        std::ifstream in(path);
+        std::string line;
+        auto field = [&](const char* key) -> const char* {
+            const std::size_t at = line.find(key);
+            return at == std::string::npos ? nullptr : line.c_str() + at + std::char_traits<char>::length(key);
+        };
+        while (std::getline(in, line)) {
+            const char* name = field("\"name\": \"");
+            const char* size = field("\"size\": ");
+            const char* median = field("\"median_ns\": ");
+            if (!name || !size || !median) continue;
+            baseline_entry e;
+            e.name.assign(name, std::strchr(name, '"'));
+            e.size = std::strtoull(size, nullptr, 10);
+            e.median = std::strtod(median, nullptr);
+            out.push_back(std::move(e));
+        }
+        return out;
+    }
+
+    /// Print current medians against a baseline and count regressions
+    /// @param threshold Relative slowdown of the median that counts as a regression (0.1 = 10%)
+    /// @param out Stream the comparison table is printed to
+    /// @return Number of benchmarks slower than baseline by more than threshold
+    inline std::size_t compare(const std::vector<result>& current, const std::vector<baseline_entry>& baseline,
+                               double threshold, FILE* out = stdout) {
+        std::size_t regressions = 0;
+        std::fprintf(out, "%-44s %10s %14s %14s %9s\n", "benchmark", "size", "baseline ns", "current ns", "change");
+        for (const result& r : current) {
+            auto it = std::find_if(baseline.begin(), baseline.end(), [&](const baseline_entry& b) {
+                return b.name == r.name && b.size == r.size;
+            });
+            if (it == baseline.end() || !(it->median > 0.0)) {
+                std::fprintf(out, "%-44s %10zu %14s %14.3f %9s\n", r.name.c_str(), r.size, "-", r.median, "new");
+                continue;
+            }
+            const double change = r.median / it->median - 1.0;
+            const bool regressed = change > threshold;
+            regressions += regressed;
+            std::fprintf(out, "%-44s %10zu %14.3f %14.3f %+8.1f%%%s\n", r.name.c_str(), r.size, it->median, r.median,
+                        100.0 * change, regressed ? "  REGRESSION" : "");
+        }
+        return regressions;
+    }
+}
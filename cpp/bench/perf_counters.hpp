@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FINCRAFTR_BENCH_HAS_PERF 1
+#else
+#define FINCRAFTR_BENCH_HAS_PERF 0
+#endif
+
+namespace fc::bench {
+    /// Hardware events read around each measurement
+    enum class counter : std::size_t { cycles, instructions, llc_misses, branch_misses };
+    inline constexpr std::size_t counter_count = 4;
+    inline constexpr std::array<const char*, counter_count> counter_names{
+        "cycles", "instructions", "llc_misses", "branch_misses"};
+
+    /// Counter totals of one measured region; NaN for events that could not be opened
+    struct counter_values {
+        std::array<double, counter_count> value{
+            std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(),
+            std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+
+        double operator[](counter c) const { return value[static_cast<std::size_t>(c)]; }
+    };
+
+    /// User-space hardware counters of the calling thread via perf_event_open(2)
+    ///
+    /// Each event is opened on its own, so a host that exposes cycles but not LLC misses
+    /// still reports what it can. Counts are scaled by time_enabled / time_running when the
+    /// kernel multiplexes them. In containers, under perf_event_paranoid > 2, without
+    /// CAP_PERFMON, or off Linux nothing opens and available() is false; measurements then
+    /// carry NaN counters and timing works as before.
+    class perf_counters {
+    public:
+        perf_counters() {
+#if FINCRAFTR_BENCH_HAS_PERF
+            const std::array<std::uint64_t, counter_count> configs{
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+            for (std::size_t k = 0; k < counter_count; ++k) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = configs[k];
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                fds_[k] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                if (fds_[k] < 0 && error_.empty())
+                    error_ = std::string("perf_event_open(") + counter_names[k] + "): " + std::strerror(errno);
+            }
+#else
+            error_ = "perf_event_open is only available on Linux";
+#endif
+        }
+
+        ~perf_counters() {
+#if FINCRAFTR_BENCH_HAS_PERF
+            for (int fd : fds_)
+                if (fd >= 0) close(fd);
+#endif
+        }
+
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        /// @return True if at least one event opened
+        bool available() const {
+            for (int fd : fds_)
+                if (fd >= 0) return true;
+            return false;
+        }
+
+        /// @return Why the first unavailable event failed to open (empty if all opened)
+        const std::string& error() const { return error_; }
+
+        /// Reset and enable every open event
+        void start() {
+#if FINCRAFTR_BENCH_HAS_PERF
+            for (int fd : fds_) {
+                if (fd < 0) continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        /// Disable every open event and read it
+        /// @return Totals since start(), NaN for events that are not open or not scheduled
+        counter_values stop() {
+            counter_values out;
+#if FINCRAFTR_BENCH_HAS_PERF
+            for (int fd : fds_)
+                if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            for (std::size_t k = 0; k < counter_count; ++k) {
+                std::uint64_t data[3] = {0, 0, 0};  // value, time_enabled, time_running
+                if (fds_[k] < 0 || read(fds_[k], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+                if (data[2] == 0) continue;
+                out.value[k] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            }
+#endif
+            return out;
+        }
+
+    private:
+        std::array<int, counter_count> fds_{-1, -1, -1, -1};
+        std::string error_;
+    };
+}
@@ -0,0 +1,408 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+
+/// co_await-able versions of the batch entry points for coroutine-based applications
+///
+/// The awaitables below work in any C++20 coroutine, whatever its promise type. Awaiting one
+/// suspends the caller and hands the work to an executor, so the thread that awaited is free
+/// to run other coroutines. The caller resumes on the executor thread that finished the
+/// work; co_await your own scheduler afterwards to move back. Each awaitable must be awaited
+/// once, directly (co_await fc::async::map(...)).
+///
+/// Cancellation uses std::stop_token: once stop is requested no further chunk starts, chunks
+/// already running finish (they write into the caller's buffers), and the caller resumes with
+/// std::system_error(std::errc::operation_canceled). Outputs of chunks that ran keep their
+/// values; the rest are left untouched. An exception thrown by the work is rethrown in the
+/// caller in the same way, after the running chunks finish.
+namespace fc::async {
+    /// Worker threads that run awaited work and resume the awaiting coroutines
+    ///
+    /// A handle to a fc::parallel::thread_pool, by default the shared one, so awaited batches
+    /// and fc::parallel::parallel_for calls (including those made by the work itself) run on
+    /// the same threads. No thread of the caller helps here, which is why the shared pool
+    /// always has at least one worker.
+    class executor {
+    public:
+        /// @param pool Pool whose workers run the work
+        explicit executor(fc::parallel::thread_pool& pool = fc::parallel::thread_pool::instance()) : pool_(&pool) {}
+
+        /// @return The executor over the shared pool
+        static executor& instance() {
+            static executor ex;
+            return ex;
+        }
+
+        /// @return Number of worker threads
+        unsigned size() const { return pool_->size(); }
+
+        /// @return The pool the work runs on
+        fc::parallel::thread_pool& pool() const { return *pool_; }
+
+        /// Run f on a worker thread
+        /// @param f Callable invoked as f(); it must not throw
+        template <class F>
+        void post(F&& f) { pool_->submit(std::forward<F>(f)); }
+
+        /// co_await ex.schedule() continues the coroutine on a worker thread
+        auto schedule() {
+            struct awaiter {
+                executor& ex;
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> h) { ex.post([h] { h.resume(); }); }
+                void await_resume() const noexcept {}
+            };
+            return awaiter{*this};
+        }
+
+    private:
+        fc::parallel::thread_pool* pool_;
+    };
+
+    namespace detail {
+        [[noreturn]] inline void throw_cancelled() {
+            throw std::system_error(std::make_error_code(std::errc::operation_canceled), "fc::async");
+        }
+
+        /// Chunks of [0, n) claimed dynamically by up to executor::size() workers
+        ///
+        /// Lives in the awaitable, i.e. in the frame of the suspended coroutine. Workers only
+        /// touch it until the last one leaves, which then calls done(); nothing may touch it
+        /// after that, because done() may resume and destroy the coroutine.
+        class chunk_runner {
+        public:
+            chunk_runner(executor& ex, std::size_t n, std::size_t grain, std::stop_token stop)
+                : ex_(ex), n_(n), grain_(grain == 0 ? 1 : grain), chunks_((n + grain_ - 1) / grain_),
+                  stop_(std::move(stop)) {}
+
+            /// Post the workers; body(begin, end) runs per chunk and done() once at the end
+            template <class Body, class Done>
+            void start(Body& body, Done& done) {
+                executor& ex = ex_;
+                const unsigned workers = static_cast<unsigned>(std::min<std::size_t>(ex.size(), chunks_));
+                active_.store(workers, std::memory_order_relaxed);
+                chunk_runner* self = this;
+                // done() cannot run before the last worker is posted, as active_ counts them all
+                for (unsigned t = 0; t < workers; ++t)
+                    ex.post([self, &body, &done] { self->work(body, done); });
+            }
+
+            std::size_t chunks() const { return chunks_; }
+
+            /// @return Whether every chunk ran; rethrows the first exception of a chunk
+            bool finish() {
+                if (error_) std::rethrow_exception(error_);
+                return completed_.load(std::memory_order_relaxed) == chunks_;
+            }
+
+            void cancel() { abandoned_.store(true, std::memory_order_relaxed); }
+
+        private:
+            template <class Body, class Done>
+            void work(Body& body, Done& done) {
+                FINCRAFTR_TRACE_SPAN("async::chunks", n_);
+                for (;;) {
+                    if (abandoned_.load(std::memory_order_relaxed) || stop_.stop_requested()) break;
+                    const std::size_t c = next_.fetch_add(1, std::memory_order_relaxed);
+                    if (c >= chunks_) break;
+                    const std::size_t b = c * grain_, e = std::min(n_, b + grain_);
+                    try {
+                        body(b, e);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex_);
+                        if (!error_) error_ = std::current_exception();
+                        abandoned_.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                    completed_.fetch_add(1, std::memory_order_relaxed);
+                }
+                // acq_rel: the last worker sees every other worker's writes before done()
+                if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) done();
+            }
+
+            executor& ex_;
+            std::size_t n_, grain_, chunks_;
+            std::stop_token stop_;
+            std::atomic<std::size_t> next_{0};
+            std::atomic<std::size_t> completed_{0};
+            std::atomic<unsigned> active_{0};
+            std::atomic<bool> abandoned_{false};
+            std::mutex error_mutex_;
+            std::exception_ptr error_;
+        };
+
+        template <class Body>
+        class parallel_for_awaitable {
+        public:
+            parallel_for_awaitable(executor& ex, std::size_t n, std::size_t grain, Body body, std::stop_token stop)
+                : body_(std::move(body)), runner_(ex, n, grain, std::move(stop)) {}
+
+            bool await_ready() const noexcept { return runner_.chunks() == 0; }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                caller_ = h;
+                runner_.start(body_, resume_);
+            }
+
+            void await_resume() {
+                if (!runner_.finish()) throw_cancelled();
+            }
+
+        private:
+            struct resumer {
+                parallel_for_awaitable* self;
+                void operator()() const { self->caller_.resume(); }
+            };
+
+            Body body_;
+            chunk_runner runner_;
+            std::coroutine_handle<> caller_;
+            resumer resume_{this};
+        };
+    }
+
+    /// co_await-able fc::parallel::parallel_for: body(begin, end) over [0, n) in chunks
+    /// @param ex Executor running the chunks
+    /// @param n Number of items
+    /// @param grain Items per chunk (0 is treated as 1)
+    /// @param body Callable invoked as body(std::size_t begin, std::size_t end), concurrently
+    /// @param stop Cancels chunks that have not started
+    /// @return Awaitable; co_await resumes the caller once every chunk has finished
+    /// @throws std::system_error (operation_canceled) from co_await if stop cut the loop short;
+    ///         the first exception thrown by body otherwise
+    template <class Body>
+    auto parallel_for(executor& ex, std::size_t n, std::size_t grain, Body body, std::stop_token stop = {}) {
+        return detail::parallel_for_awaitable<Body>(ex, n, grain, std::move(body), std::move(stop));
+    }
+
+    /// co_await-able fc::batch::map: out[i] = f(in[0][i], ..., in[N-1][i])
+    /// @param ex Executor running the chunks
+    /// @param f Scalar kernel taking N doubles; must be safe to call concurrently
+    /// @param n Number of elements
+    /// @param in Input operands (stride 0 or 1)
+    /// @param out Output buffer of n elements
+    /// @param stop Cancels chunks that have not started
+    /// @return Awaitable; co_await resumes the caller once out is complete
+    /// @throws std::system_error (operation_canceled) from co_await if stop cut the batch short
+    template <class F, class R, std::size_t N>
+    auto map(executor& ex, F f, std::size_t n, const std::array<fc::batch::operand, N>& in, R* out,
+             std::stop_token stop = {}) {
+        return parallel_for(ex, n, fc::batch::chunk_elements(N + 1),
+            [f = std::move(f), in, out](std::size_t b, std::size_t e) mutable {
+                FINCRAFTR_TRACE_SPAN("batch::chunk", e - b);
+                std::array<fc::batch::operand, N> part = in;
+                for (fc::batch::operand& op : part) op.data += b * op.stride;
+                fc::batch::map(f, e - b, part, out + b);
+            },
+            std::move(stop));
+    }
+
+    /// Stream of finished chunks: co_await next() resumes the caller as each chunk completes
+    ///
+    /// Chunks run on the executor from the first next() on and complete in any order; the
+    /// consumer can use each range of output while the rest is still being computed.
+    /// Destroying the stream before next() has returned std::nullopt cancels the chunks that
+    /// have not started and waits until the running ones finish. On one of the executor's
+    /// workers, e.g. in a coroutine resumed by schedule(), the wait runs the pool's queued
+    /// tasks instead of blocking, so it cannot starve the chunks it waits for.
+    template <class Body>
+    class chunk_stream {
+    public:
+        /// Half-open item range [begin, end) whose body call has finished
+        using range = std::pair<std::size_t, std::size_t>;
+
+        chunk_stream(executor& ex, std::size_t n, std::size_t grain, Body body, std::stop_token stop)
+            : ex_(ex), body_(std::move(body)), runner_(ex, n, grain, std::move(stop)) {}
+
+        chunk_stream(const chunk_stream&) = delete;
+        chunk_stream& operator=(const chunk_stream&) = delete;
+
+        ~chunk_stream() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!started_ || finished_) return;
+                runner_.cancel();
+                waiter_ = nullptr;  // A coroutine destroyed inside next() must not be resumed
+            }
+            fc::parallel::thread_pool& pool = ex_.pool();
+            if (pool.on_worker()) {
+                pool.wait_until([this] {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return finished_;
+                });
+            } else {
+                std::unique_lock<std::mutex> lock(mutex_);
+                idle_.wait(lock, [this] { return finished_; });
+            }
+        }
+
+        /// @return Awaitable yielding the next finished range, or std::nullopt when all are done
+        /// @throws std::system_error (operation_canceled) from co_await if stop cut the stream
+        ///         short; the first exception thrown by body otherwise
+        auto next() {
+            struct awaiter {
+                chunk_stream& s;
+                bool await_ready() const noexcept { return false; }
+                bool await_suspend(std::coroutine_handle<> h) {
+                    std::lock_guard<std::mutex> lock(s.mutex_);
+                    if (!s.started_) {
+                        s.started_ = true;
+                        if (s.runner_.chunks() == 0) s.finished_ = true;
+                        else s.runner_.start(s.record_, s.end_);
+                    }
+                    if (!s.ready_.empty() || s.finished_) return false;
+                    s.waiter_ = h;
+                    return true;
+                }
+                std::optional<range> await_resume() {
+                    std::lock_guard<std::mutex> lock(s.mutex_);
+                    if (!s.ready_.empty()) {
+                        range r = s.ready_.front();
+                        s.ready_.pop_front();
+                        return r;
+                    }
+                    if (!s.runner_.finish()) detail::throw_cancelled();
+                    return std::nullopt;
+                }
+            };
+            return awaiter{*this};
+        }
+
+    private:
+        struct recorder {
+            chunk_stream* self;
+            void operator()(std::size_t b, std::size_t e) const {
+                self->body_(b, e);
+                std::coroutine_handle<> h;
+                {
+                    std::lock_guard<std::mutex> lock(self->mutex_);
+                    self->ready_.emplace_back(b, e);
+                    h = std::exchange(self->waiter_, nullptr);
+                }
+                // Resume through the queue so this worker goes on to the next chunk
+                if (h) self->ex_.post([h] { h.resume(); });
+            }
+        };
+
+        struct finisher {
+            chunk_stream* self;
+            void operator()() const {
+                std::coroutine_handle<> h;
+                {
+                    std::lock_guard<std::mutex> lock(self->mutex_);
+                    self->finished_ = true;
+                    h = std::exchange(self->waiter_, nullptr);
+                    self->idle_.notify_all();
+                }
+                if (h) h.resume();
+            }
+        };
+
+        executor& ex_;
+        Body body_;
+        detail::chunk_runner runner_;
+        recorder record_{this};
+        finisher end_{this};
+        std::mutex mutex_;
+        std::condition_variable idle_;
+        std::deque<range> ready_;
+        std::coroutine_handle<> waiter_;
+        bool started_ = false;
+        bool finished_ = false;
+    };
+
+    /// Run body(begin, end) over [0, n) in chunks and stream the finished ranges
+    /// @param ex Executor running the chunks
+    /// @param n Number of items
+    /// @param grain Items per chunk (0 is treated as 1)
+    /// @param body Callable invoked as body(std::size_t begin, std::size_t end), concurrently
+    /// @param stop Cancels chunks that have not started
+    /// @return Stream to co_await next() on; it must outlive the chunks, so keep it in a variable
+    template <class Body>
+    chunk_stream<Body> chunks(executor& ex, std::size_t n, std::size_t grain, Body body, std::stop_token stop = {}) {
+        return chunk_stream<Body>(ex, n, grain, std::move(body), std::move(stop));
+    }
+
+    namespace detail {
+        template <class F>
+        decltype(auto) invoke_with_stop(F& f, const std::stop_token& stop) {
+            if constexpr (std::is_invocable_v<F&, std::stop_token>) return f(stop);
+            else return f();
+        }
+
+        template <class F>
+        using run_result = std::remove_cvref_t<decltype(invoke_with_stop(std::declval<F&>(), std::declval<const std::stop_token&>()))>;
+
+        template <class F>
+        class run_awaitable {
+            using result_type = run_result<F>;
+            using storage = std::conditional_t<std::is_void_v<result_type>, bool, std::optional<result_type>>;
+
+        public:
+            run_awaitable(executor& ex, F f, std::stop_token stop)
+                : ex_(ex), f_(std::move(f)), stop_(std::move(stop)) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                ex_.post([this, h] {
+                    if (stop_.stop_requested()) {
+                        cancelled_ = true;
+                    } else {
+                        FINCRAFTR_TRACE_SPAN("async::run", 1);
+                        try {
+                            if constexpr (std::is_void_v<result_type>) invoke_with_stop(f_, stop_);
+                            else value_.emplace(invoke_with_stop(f_, stop_));
+                        } catch (...) {
+                            error_ = std::current_exception();
+                        }
+                    }
+                    h.resume();
+                });
+            }
+
+            result_type await_resume() {
+                if (error_) std::rethrow_exception(error_);
+                if (cancelled_) throw_cancelled();
+                if constexpr (!std::is_void_v<result_type>) return std::move(*value_);
+            }
+
+        private:
+            executor& ex_;
+            F f_;
+            std::stop_token stop_;
+            storage value_{};
+            std::exception_ptr error_;
+            bool cancelled_ = false;
+        };
+    }
+
+    /// Run a heavy call on the executor, e.g. an index recomputation or a whole DCF run
+    /// @param ex Executor to run on
+    /// @param f Callable taking no arguments, or a std::stop_token to poll for cancellation
+    /// @param stop Skips f if requested before it starts; passed on to f if it takes one
+    /// @return Awaitable yielding f's result
+    /// @throws std::system_error (operation_canceled) from co_await if f was skipped; whatever
+    ///         f throws otherwise
+    template <class F>
+    auto run(executor& ex, F f, std::stop_token stop = {}) {
+        return detail::run_awaitable<F>(ex, std::move(f), std::move(stop));
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "parallel.hpp"
+#include "trace.hpp"
+
+namespace fc::batch {
+    /// Bytes of input plus output a single parallel chunk should touch (about one L2 cache)
+    inline constexpr std::size_t chunk_bytes = 256 * 1024;
+
+    /// Elements per parallel chunk for a kernel with the given number of double columns
+    /// @param columns Input plus output columns streamed per element
+    /// @return Chunk size, a multiple of 64 elements and at least 1024
+    inline constexpr std::size_t chunk_elements(std::size_t columns) {
+        const std::size_t n = chunk_bytes / (sizeof(double) * (columns == 0 ? 1 : columns));
+        return n < 1024 ? 1024 : n - n % 64;
+    }
+
+    /// One input column of an elementwise batch: element i is data[i * stride]
+    ///
+    /// A stride of 1 walks a contiguous buffer; a stride of 0 broadcasts a single value.
+    struct operand {
+        const double* data = nullptr;
+        std::size_t stride = 1;
+    };
+
+    namespace detail {
+        template <class F, class R, std::size_t N, std::size_t... I>
+        void map_contiguous(F& f, std::size_t n, const std::array<operand, N>& in, R* out,
+                            std::index_sequence<I...>) {
+            const std::array<const double*, N> p{in[I].data...};
+            for (std::size_t i = 0; i < n; ++i) out[i] = f(p[I][i]...);
+        }
+
+        template <class F, class R, std::size_t N, std::size_t... I>
+        void map_strided(F& f, std::size_t n, const std::array<operand, N>& in, R* out,
+                         std::index_sequence<I...>) {
+            for (std::size_t i = 0; i < n; ++i) out[i] = f(in[I].data[i * in[I].stride]...);
+        }
+    }
+
+    /// Apply a scalar kernel elementwise: out[i] = f(in[0][i], ..., in[N-1][i])
+    /// @param f Scalar kernel taking N doubles
+    /// @param n Number of elements
+    /// @param in Input operands (stride 0 or 1)
+    /// @param out Output buffer of n elements
+    /// @note When every operand is contiguous the loop runs over plain pointers so the
+    ///       compiler can inline and vectorize the kernel.
+    template <class F, class R, std::size_t N>
+    void map(F&& f, std::size_t n, const std::array<operand, N>& in, R* out) {
+        bool contiguous = true;
+        for (const operand& op : in) contiguous = contiguous && op.stride == 1;
+        if (contiguous)
+            detail::map_contiguous(f, n, in, out, std::make_index_sequence<N>{});
+        else
+            detail::map_strided(f, n, in, out, std::make_index_sequence<N>{});
+    }
+
+    /// Apply a scalar kernel elementwise across threads
+    /// @param f Scalar kernel taking N doubles; must be safe to call concurrently
+    /// @param n Number of elements
+    /// @param in Input operands (stride 0 or 1)
+    /// @param out Output buffer of n elements
+    /// @param threads Number of threads (0 = hardware concurrency, 1 = calling thread only)
+    /// @note Work is split into chunk_elements(N + 1) sized chunks so each chunk's working set
+    ///       stays cache resident; chunks are handed out dynamically by fc::parallel::parallel_for.
+    template <class F, class R, std::size_t N>
+    void map(F&& f, std::size_t n, const std::array<operand, N>& in, R* out, unsigned threads) {
+        FINCRAFTR_TRACE_SPAN("batch::map", n);
+        fc::parallel::parallel_for(n, chunk_elements(N + 1), threads,
+            [&](std::size_t b, std::size_t e) {
+                FINCRAFTR_TRACE_SPAN("batch::chunk", e - b);
+                std::array<operand, N> part = in;
+                for (operand& op : part) op.data += b * op.stride;
+                map(f, e - b, part, out + b);
+            });
+    }
+}
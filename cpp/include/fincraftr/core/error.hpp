@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace fc {
+    /// Error codes reported by the status error policy
+    enum class errc : std::uint8_t {
+        ok = 0,               ///< No error
+        invalid_argument = 1, ///< An input violated the function's precondition
+    };
+
+    /// Value-or-error result returned under policy::status
+    /// @tparam T Value type
+    template <class T>
+    class result {
+    public:
+        constexpr result(T value, errc error = errc::ok) : value_(value), error_(error) {}
+
+        /// @return True if no error occurred
+        constexpr bool has_value() const { return error_ == errc::ok; }
+        constexpr explicit operator bool() const { return has_value(); }
+
+        /// @return Error code (errc::ok on success)
+        constexpr errc error() const { return error_; }
+
+        /// @return The computed value
+        /// @throws std::invalid_argument if the result holds an error
+        constexpr T value() const {
+            if (!has_value()) throw std::invalid_argument("fc::result holds an error");
+            return value_;
+        }
+
+        /// @param fallback Value returned when the result holds an error
+        /// @return The computed value, or fallback on error
+        constexpr T value_or(T fallback) const { return has_value() ? value_ : fallback; }
+
+    private:
+        T value_;
+        errc error_;
+    };
+
+    /// Compile-time error policies selecting how functions report invalid inputs
+    ///
+    /// Functions with a failure mode take the policy as their first template parameter,
+    /// defaulting to policy::throwing. Each policy provides result_type<T> and
+    /// check(ok, value, message), which turns a precondition and the unconditionally
+    /// computed value into the function's return value.
+    namespace policy {
+        /// Throw std::invalid_argument (the library default)
+        struct throwing {
+            template <class T> using result_type = T;
+            template <class T>
+            static T check(bool ok, T value, const char* message) {
+                if (!ok) throw std::invalid_argument(message);
+                return value;
+            }
+        };
+
+        /// Return quiet NaN on error; never throws and compiles to a select
+        struct nan {
+            template <class T> using result_type = T;
+            template <class T>
+            static constexpr T check(bool ok, T value, const char*) {
+                return ok ? value : std::numeric_limits<T>::quiet_NaN();
+            }
+        };
+
+        /// Return fc::result<T> carrying the value and an error code; never throws
+        struct status {
+            template <class T> using result_type = result<T>;
+            template <class T>
+            static constexpr result<T> check(bool ok, T value, const char*) {
+                return result<T>(ok ? value : std::numeric_limits<T>::quiet_NaN(),
+                                 ok ? errc::ok : errc::invalid_argument);
+            }
+        };
+    }
+
+    /// Evaluate a status-policy kernel per element and collect an error mask
+    /// @param kernel Callable invoked as kernel(i) returning fc::result<double>
+    /// @param out Output values (NaN where the element failed)
+    /// @param errors Output error codes, same length as out
+    /// @return Number of failed elements
+    /// @throws std::invalid_argument if out and errors differ in length
+    template <class Kernel>
+    std::size_t collect_errors(Kernel&& kernel, std::span<double> out, std::span<errc> errors) {
+        if (out.size() != errors.size()) throw std::invalid_argument("out and errors must have equal length");
+        std::size_t failed = 0;
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            const result<double> r = kernel(i);
+            out[i] = r.value_or(std::numeric_limits<double>::quiet_NaN());
+            errors[i] = r.error();
+            failed += (r.error() != errc::ok);
+        }
+        return failed;
+    }
+}
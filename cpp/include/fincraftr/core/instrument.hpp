@@ -0,0 +1,321 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(FINCRAFTR_INSTRUMENT)
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+/// Opt-in hot-path instrumentation
+///
+/// Building with FINCRAFTR_INSTRUMENT defined (CMake option FINCRAFTR_INSTRUMENT) makes every
+/// public function, engine and batch kernel record, per thread: calls, elements processed,
+/// total cycles and a log2 histogram of cycles per call, read from the time-stamp counter
+/// (rdtsc on x86, cntvct_el0 on AArch64, steady_clock elsewhere). snapshot() and report()
+/// aggregate all threads. Without the define FINCRAFTR_PROBE expands to nothing, so the
+/// library compiles to exactly the uninstrumented code, and snapshot() is always empty.
+/// Time is charged to the outermost instrumented call, so the totals add up to the time
+/// spent inside fincraftr on each thread (work an engine hands to pool threads shows up
+/// under the functions those threads run).
+///
+/// A probe costs two counter reads and a few relaxed stores (~20-40 cycles), which is
+/// comparable to the cheapest scalar functions and stops batch loops from vectorizing, so
+/// use instrumented builds to find where time goes, not to time the kernels themselves.
+namespace fc::instrument {
+    /// Maximum number of distinct instrumented functions
+    inline constexpr std::size_t max_sites = 256;
+
+    /// Histogram buckets: bucket b counts calls that took [2^b, 2^(b+1)) cycles (bucket 0
+    /// also counts 0 and 1; the last bucket counts everything longer)
+    inline constexpr std::size_t histogram_buckets = 40;
+
+#if defined(FINCRAFTR_INSTRUMENT)
+    inline constexpr bool enabled = true;
+#else
+    inline constexpr bool enabled = false;
+#endif
+
+    /// Counters of one instrumented function, summed over threads
+    struct function_stats {
+        std::string name;            ///< Qualified name, e.g. "equity::market_cap"
+        std::uint64_t calls = 0;
+        std::uint64_t elements = 0;  ///< Elements processed (1 per call for scalar functions)
+        std::uint64_t cycles = 0;    ///< Total counter ticks inside the function
+        unsigned threads = 0;        ///< Threads that called it since the last reset
+        std::array<std::uint64_t, histogram_buckets> histogram{};
+
+        /// @return Mean ticks per call (0 if never called)
+        double cycles_per_call() const { return calls ? static_cast<double>(cycles) / static_cast<double>(calls) : 0.0; }
+
+        /// @return Mean ticks per element (0 if no elements)
+        double cycles_per_element() const {
+            return elements ? static_cast<double>(cycles) / static_cast<double>(elements) : 0.0;
+        }
+
+        /// Percentile of ticks per call, resolved to histogram buckets
+        /// @param p Percentile in [0, 100]
+        /// @return Upper bound of the bucket holding the percentile (0 if never called)
+        std::uint64_t percentile_cycles(double p) const {
+            if (calls == 0) return 0;
+            const double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(calls);
+            std::uint64_t seen = 0;
+            for (std::size_t b = 0; b < histogram_buckets; ++b) {
+                seen += histogram[b];
+                if (static_cast<double>(seen) >= rank && seen > 0) return (std::uint64_t{2} << b) - 1;
+            }
+            return (std::uint64_t{2} << (histogram_buckets - 1)) - 1;
+        }
+    };
+
+#if defined(FINCRAFTR_INSTRUMENT)
+    namespace detail {
+        /// @return Current value of the cycle counter
+        inline std::uint64_t ticks() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            std::uint64_t v;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+            return v;
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        /// Counters of one function on one thread; written only by that thread
+        struct site_counters {
+            std::atomic<std::uint64_t> calls{0}, elements{0}, cycles{0};
+            std::array<std::atomic<std::uint64_t>, histogram_buckets> histogram{};
+        };
+
+        struct thread_counters {
+            std::array<site_counters, max_sites> sites;
+            unsigned depth = 0;  ///< Probes currently open on the owning thread
+        };
+
+        inline void bump(std::atomic<std::uint64_t>& c, std::uint64_t by) noexcept {
+            c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        }
+
+        /// Site names and live per-thread counters; counters of exited threads are folded
+        /// into `retired` so memory stays bounded under thread churn
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::string> names;
+            std::vector<thread_counters*> live;
+            thread_counters retired;
+            std::array<unsigned, max_sites> retired_threads{};
+
+            static registry& instance() {
+                static registry* r = new registry;  // leaked: probes may run during static destruction
+                return *r;
+            }
+        };
+
+        /// Add one thread's counters into an aggregate
+        inline void fold(thread_counters& into, const thread_counters& from) {
+            for (std::size_t s = 0; s < max_sites; ++s) {
+                const site_counters& f = from.sites[s];
+                site_counters& t = into.sites[s];
+                bump(t.calls, f.calls.load(std::memory_order_relaxed));
+                bump(t.elements, f.elements.load(std::memory_order_relaxed));
+                bump(t.cycles, f.cycles.load(std::memory_order_relaxed));
+                for (std::size_t b = 0; b < histogram_buckets; ++b)
+                    bump(t.histogram[b], f.histogram[b].load(std::memory_order_relaxed));
+            }
+        }
+
+        /// Owns the calling thread's counters and retires them at thread exit
+        struct thread_slot {
+            std::unique_ptr<thread_counters> counters = std::make_unique<thread_counters>();
+
+            thread_slot() {
+                registry& r = registry::instance();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.live.push_back(counters.get());
+            }
+
+            ~thread_slot() {
+                registry& r = registry::instance();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                fold(r.retired, *counters);
+                for (std::size_t s = 0; s < max_sites; ++s)
+                    r.retired_threads[s] += counters->sites[s].calls.load(std::memory_order_relaxed) != 0;
+                r.live.erase(std::find(r.live.begin(), r.live.end(), counters.get()));
+            }
+        };
+
+        inline thread_counters& local() {
+            thread_local thread_slot slot;
+            return *slot.counters;
+        }
+
+        /// Id of a named site, registering it on first use; the same name always maps to
+        /// the same id (template instantiations and ISA clones share one entry)
+        /// @return Site id, or max_sites if the table is full (the probe is then ignored)
+        inline std::uint32_t site_id(const char* name) {
+            registry& r = registry::instance();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            auto it = std::find(r.names.begin(), r.names.end(), name);
+            if (it != r.names.end()) return static_cast<std::uint32_t>(it - r.names.begin());
+            if (r.names.size() == max_sites) return static_cast<std::uint32_t>(max_sites);
+            r.names.emplace_back(name);
+            return static_cast<std::uint32_t>(r.names.size() - 1);
+        }
+
+        inline void record(thread_counters& t, std::uint32_t site, std::uint64_t elements,
+                           std::uint64_t cycles) noexcept {
+            site_counters& c = t.sites[site];
+            bump(c.calls, 1);
+            bump(c.elements, elements);
+            bump(c.cycles, cycles);
+            const std::size_t bucket = cycles < 2 ? 0 : static_cast<std::size_t>(std::bit_width(cycles) - 1);
+            bump(c.histogram[std::min(bucket, histogram_buckets - 1)], 1);
+        }
+
+        /// Scoped timer placed by FINCRAFTR_PROBE; only the outermost probe on a thread
+        /// records, so a kernel or engine is not also charged for the functions it calls
+        class probe {
+        public:
+            probe(std::uint32_t site, std::uint64_t elements) noexcept
+                : counters_(local()), site_(site), elements_(elements),
+                  outer_(counters_.depth++ == 0 && site < max_sites), start_(outer_ ? ticks() : 0) {}
+            ~probe() {
+                if (outer_) record(counters_, site_, elements_, ticks() - start_);
+                --counters_.depth;
+            }
+            probe(const probe&) = delete;
+            probe& operator=(const probe&) = delete;
+
+        private:
+            thread_counters& counters_;
+            std::uint32_t site_;
+            std::uint64_t elements_;
+            bool outer_;
+            std::uint64_t start_;
+        };
+    }
+
+    /// Aggregate the counters of every thread, including threads that have exited
+    /// @return One entry per function called since the last reset, most cycles first
+    inline std::vector<function_stats> snapshot() {
+        detail::registry& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::vector<function_stats> out;
+        for (std::size_t s = 0; s < r.names.size(); ++s) {
+            function_stats f;
+            f.name = r.names[s];
+            f.threads = r.retired_threads[s];
+            auto add = [&](const detail::site_counters& c) {
+                f.calls += c.calls.load(std::memory_order_relaxed);
+                f.elements += c.elements.load(std::memory_order_relaxed);
+                f.cycles += c.cycles.load(std::memory_order_relaxed);
+                for (std::size_t b = 0; b < histogram_buckets; ++b)
+                    f.histogram[b] += c.histogram[b].load(std::memory_order_relaxed);
+            };
+            add(r.retired.sites[s]);
+            for (const detail::thread_counters* t : r.live) {
+                f.threads += t->sites[s].calls.load(std::memory_order_relaxed) != 0;
+                add(t->sites[s]);
+            }
+            if (f.calls) out.push_back(std::move(f));
+        }
+        std::sort(out.begin(), out.end(), [](const function_stats& a, const function_stats& b) {
+            return a.cycles > b.cycles;
+        });
+        return out;
+    }
+
+    /// Zero every counter
+    /// @note Calls that complete on other threads while reset runs may be partly lost
+    inline void reset() {
+        detail::registry& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto clear = [](detail::thread_counters& t) {
+            for (detail::site_counters& c : t.sites) {
+                c.calls.store(0, std::memory_order_relaxed);
+                c.elements.store(0, std::memory_order_relaxed);
+                c.cycles.store(0, std::memory_order_relaxed);
+                for (auto& h : c.histogram) h.store(0, std::memory_order_relaxed);
+            }
+        };
+        clear(r.retired);
+        r.retired_threads.fill(0);
+        for (detail::thread_counters* t : r.live) clear(*t);
+    }
+
+    /// Counter ticks per nanosecond, measured once against steady_clock over ~10 ms
+    inline double ticks_per_ns() {
+        static const double rate = [] {
+            using clock = std::chrono::steady_clock;
+            const auto t0 = clock::now();
+            const std::uint64_t c0 = detail::ticks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            const std::uint64_t c1 = detail::ticks();
+            const double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+            return ns > 0.0 ? static_cast<double>(c1 - c0) / ns : 1.0;
+        }();
+        return rate;
+    }
+#else
+    inline std::vector<function_stats> snapshot() { return {}; }
+    inline void reset() {}
+    inline double ticks_per_ns() { return 0.0; }
+#endif
+
+    /// Format snapshot() as a fixed-width table
+    /// @return Table with calls, elements, ticks per call/element, p50/p99 ticks per call and
+    ///         total milliseconds for every instrumented function, most expensive first
+    inline std::string report() {
+        if constexpr (!enabled) return "fincraftr was built without FINCRAFTR_INSTRUMENT\n";
+        const std::vector<function_stats> stats = snapshot();
+        const double rate = ticks_per_ns();
+        std::string out;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-42s %12s %14s %12s %12s %10s %10s %10s %7s\n", "function", "calls",
+                      "elements", "cyc/call", "cyc/elem", "p50", "p99", "total ms", "threads");
+        out += line;
+        for (const function_stats& f : stats) {
+            std::snprintf(line, sizeof(line), "%-42s %12llu %14llu %12.1f %12.2f %10llu %10llu %10.3f %7u\n",
+                          f.name.c_str(), static_cast<unsigned long long>(f.calls),
+                          static_cast<unsigned long long>(f.elements), f.cycles_per_call(), f.cycles_per_element(),
+                          static_cast<unsigned long long>(f.percentile_cycles(50.0)),
+                          static_cast<unsigned long long>(f.percentile_cycles(99.0)),
+                          rate > 0.0 ? static_cast<double>(f.cycles) / rate * 1e-6 : 0.0, f.threads);
+            out += line;
+        }
+        return out;
+    }
+}
+
+#define FINCRAFTR_INSTRUMENT_CAT2(a, b) a##b
+#define FINCRAFTR_INSTRUMENT_CAT(a, b) FINCRAFTR_INSTRUMENT_CAT2(a, b)
+
+/// Time the rest of the enclosing scope as function `name` processing `elements` elements
+#if defined(FINCRAFTR_INSTRUMENT)
+#define FINCRAFTR_PROBE(name, elements)                                                                  \
+    static const std::uint32_t FINCRAFTR_INSTRUMENT_CAT(fincraftr_site_, __LINE__) =                     \
+        ::fc::instrument::detail::site_id(name);                                                         \
+    const ::fc::instrument::detail::probe FINCRAFTR_INSTRUMENT_CAT(fincraftr_probe_, __LINE__)(          \
+        FINCRAFTR_INSTRUMENT_CAT(fincraftr_site_, __LINE__), static_cast<std::uint64_t>(elements))
+#else
+#define FINCRAFTR_PROBE(name, elements) static_cast<void>(0)
+#endif
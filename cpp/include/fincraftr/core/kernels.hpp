@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+
+/// Out-of-line batch kernels compiled into the fincraftr shared and static libraries
+///
+/// Each kernel computes out[i] = f(in_0[i], ..., in_k[i]) for i < n, where f is the scalar
+/// function of the same name and the inputs are contiguous arrays of n doubles (out may
+/// alias an input). Functions that reject inputs use their fc::policy::nan instantiation,
+/// so rejected elements become NaN, and functions with an exp, log or pow use their
+/// fc::math::fast instantiation, so results may differ from the scalar default
+/// (fc::math::exact) by the ulp bounds documented in core/math.hpp.
+///
+/// On x86-64 with GCC or Clang each kernel is built for several ISA levels (x86-64-v2,
+/// AVX2+FMA, AVX-512) and the best one is bound once at load time through ifunc
+/// resolution, so the same binary runs at full width on every host. Other targets get a
+/// single portable build. Requires linking fincraftr::shared or fincraftr::static; header-only
+/// users can get the same loops from fc::batch::map.
+namespace fc::kernels {
+    /// @return ISA level the dispatched kernels run at on this host: "x86-64-v4", "x86-64-v3"
+    ///         or "x86-64-v2" when built with GCC 12 or later, "avx512", "avx2" or "sse4.2"
+    ///         with older compilers and Clang, otherwise "baseline"
+    const char* isa();
+
+    // Equity
+    void market_cap(std::size_t n, const double* shares_outstanding, const double* price, double* out);
+    void ownership_fraction(std::size_t n, const double* shares_owned, const double* shares_outstanding, double* out);
+    void return_simple(std::size_t n, const double* Pt, const double* Pt_prev, double* out);
+    void profit_simple(std::size_t n, const double* S0, const double* ST, const double* r, const double* tau,
+                       double* out);
+    void profit_with_costs(std::size_t n, const double* S0, const double* ST, const double* r, const double* tau,
+                           const double* D_tau, const double* C0, double* out);
+    void ddm_single_period(std::size_t n, const double* D1, const double* S1, const double* r, double* out);
+    void cost_of_equity(std::size_t n, const double* D1, const double* S1, const double* S0, double* out);
+    void ddm_gordon_growth(std::size_t n, const double* D1, const double* r, const double* g, double* out);
+
+    // Options
+    void payoff_call(std::size_t n, const double* ST, const double* K, double* out);
+    void payoff_put(std::size_t n, const double* ST, const double* K, double* out);
+    void payoff_asian_call(std::size_t n, const double* average_price, const double* K, double* out);
+    void profit_call(std::size_t n, const double* ST, const double* K, const double* premium, const double* r,
+                     const double* tau, double* out);
+    void hedge_ratio_binomial(std::size_t n, const double* Cu, const double* Cd, const double* Su, const double* Sd,
+                              double* out);
+    void loan_binomial(std::size_t n, const double* Cu, const double* Cd, const double* Su, const double* Sd,
+                       const double* r, double* out);
+    void price_binomial_one_period(std::size_t n, const double* S0, const double* Delta, const double* B_hat,
+                                   const double* r, const double* tau, double* out);
+    void price_risk_neutral_one_period(std::size_t n, const double* S0, const double* Su, const double* Sd,
+                                       const double* Cu, const double* Cd, const double* r, const double* tau,
+                                       double* out);
+
+    // Forwards
+    void forward_price_no_div(std::size_t n, const double* S, const double* r, const double* tau, double* out);
+    void forward_price_with_div(std::size_t n, const double* S, const double* D, const double* r, const double* tau,
+                                double* out);
+    void forward_price_cont_yield(std::size_t n, const double* S, const double* r, const double* q,
+                                  const double* tau, double* out);
+
+    // Rates (m is truncated to int for compound_discrete, as in the scalar function)
+    void compound_discrete(std::size_t n, const double* p0, const double* r, const double* m, const double* years,
+                           double* out);
+    void compound_continuous(std::size_t n, const double* p0, const double* r, const double* t, double* out);
+    void roll_forward_cont(std::size_t n, const double* P_t, const double* r, const double* tau, double* out);
+    void roll_back_cont(std::size_t n, const double* P_t, const double* r, const double* tau, double* out);
+    void nominal_to_continuous(std::size_t n, const double* R, const double* m, double* out);
+    void continuous_to_nominal(std::size_t n, const double* r, const double* m, double* out);
+
+    /// Single-precision kernels for scenario cubes and Monte Carlo paths
+    ///
+    /// Inputs and outputs are float, which halves the memory traffic of the double kernels
+    /// on grids too large for cache. Each element is widened to double, evaluated by the
+    /// same scalar function (fc::math::fast) and rounded to float once. With respect to its
+    /// float inputs every result is therefore the correctly rounded float, except within
+    /// about 2^-26 ulp of a rounding boundary where it may be 1 ulp off (profit_call and the
+    /// binomial price also lose that guarantee when cancellation leaves a result below 2^-26
+    /// of its terms; their absolute error stays below 2^-50 of the terms). Storing the
+    /// inputs as float is the larger error: a rate or maturity rounded to float moves exp(r * tau) by up to
+    /// |r * tau| * 2^-24 relative, and spots and strikes carry 2^-24 relative each.
+    ///
+    /// The *_sum kernels return the sum of the corresponding elementwise results without
+    /// storing them, accumulated in double: each term keeps the error above and the sum
+    /// adds at most (n / 8 + 3) * 2^-53 * sum(|terms|), where a float accumulator would add
+    /// up to n * 2^-24 * sum(|terms|).
+    namespace f32 {
+        // Discounting
+        void roll_back_cont(std::size_t n, const float* P_t, const float* r, const float* tau, float* out);
+        void roll_forward_cont(std::size_t n, const float* P_t, const float* r, const float* tau, float* out);
+        void compound_continuous(std::size_t n, const float* p0, const float* r, const float* t, float* out);
+        double roll_back_cont_sum(std::size_t n, const float* P_t, const float* r, const float* tau);
+
+        // Forwards
+        void forward_price_no_div(std::size_t n, const float* S, const float* r, const float* tau, float* out);
+        void forward_price_with_div(std::size_t n, const float* S, const float* D, const float* r, const float* tau,
+                                    float* out);
+        void forward_price_cont_yield(std::size_t n, const float* S, const float* r, const float* q,
+                                      const float* tau, float* out);
+
+        // Payoffs
+        void payoff_call(std::size_t n, const float* ST, const float* K, float* out);
+        void payoff_put(std::size_t n, const float* ST, const float* K, float* out);
+        void payoff_asian_call(std::size_t n, const float* average_price, const float* K, float* out);
+        void profit_call(std::size_t n, const float* ST, const float* K, const float* premium, const float* r,
+                         const float* tau, float* out);
+        double payoff_call_sum(std::size_t n, const float* ST, const float* K);
+        double payoff_put_sum(std::size_t n, const float* ST, const float* K);
+
+        // Binomial delta and price
+        void hedge_ratio_binomial(std::size_t n, const float* Cu, const float* Cd, const float* Su, const float* Sd,
+                                  float* out);
+        void price_risk_neutral_one_period(std::size_t n, const float* S0, const float* Su, const float* Sd,
+                                           const float* Cu, const float* Cd, const float* r, const float* tau,
+                                           float* out);
+    }
+}
@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "instrument.hpp"
+#include "math.hpp"
+
+namespace fc::market {
+    /// Zero-rate curve (continuous compounding) interpolated linearly in time
+    ///
+    /// A single pillar is a flat rate. Outside the pillars the nearest rate is extended flat.
+    class rate_curve {
+    public:
+        /// Flat curve at rate r
+        rate_curve(double r = 0.0) : times_{0.0}, rates_{r} {}
+
+        /// Curve through (times[i], rates[i])
+        /// @param times Pillar times, strictly increasing
+        /// @param rates Continuous zero rates at the pillars
+        /// @throws std::invalid_argument if the sizes differ, are zero or times are not increasing
+        rate_curve(std::vector<double> times, std::vector<double> rates)
+            : times_(std::move(times)), rates_(std::move(rates)) {
+            if (times_.empty() || times_.size() != rates_.size())
+                throw std::invalid_argument("rate curve needs equally many (at least one) times and rates");
+            for (std::size_t k = 1; k < times_.size(); ++k)
+                if (!(times_[k] > times_[k - 1])) throw std::invalid_argument("rate curve times must be strictly increasing");
+        }
+
+        /// @param t Time
+        /// @return Continuous zero rate to t
+        double rate(double t) const {
+            if (t <= times_.front()) return rates_.front();
+            if (t >= times_.back()) return rates_.back();
+            const std::size_t k = static_cast<std::size_t>(
+                std::upper_bound(times_.begin(), times_.end(), t) - times_.begin());
+            const double w = (t - times_[k - 1]) / (times_[k] - times_[k - 1]);
+            return rates_[k - 1] + w * (rates_[k] - rates_[k - 1]);
+        }
+
+        /// @param t Time
+        /// @return Discount factor exp(-rate(t) t)
+        double discount(double t) const { return fc::math::exp(-rate(t) * t); }
+
+        const std::vector<double>& times() const { return times_; }
+        const std::vector<double>& rates() const { return rates_; }
+
+    private:
+        std::vector<double> times_;
+        std::vector<double> rates_;
+    };
+
+    /// Discrete cash dividend
+    struct dividend {
+        double time = 0.0;    ///< Payment time, on the same axis as curve times
+        double amount = 0.0;  ///< Cash amount per share
+    };
+
+    namespace detail {
+        /// Lets the maps below be searched with std::string_view and string literals
+        struct name_hash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+
+        template <class T>
+        using name_map = std::unordered_map<std::string, T, name_hash, std::equal_to<>>;
+
+        template <class T>
+        const T& find(const name_map<T>& map, std::string_view name, const char* what) {
+            auto it = map.find(name);
+            if (it == map.end()) throw std::invalid_argument(std::string("no ") + what + " for '" + std::string(name) + "'");
+            return it->second;
+        }
+    }
+
+    /// One consistent set of market inputs, keyed by instrument or curve name
+    ///
+    /// The accessors return the values the pricing functions take: spot(name) and
+    /// dividend_yield(name) feed forward_price_cont_yield, curve(name).rate(tau) is the r of
+    /// the rates and forwards functions, and dividends_pv(name, curve, tau) is the D of
+    /// forward_price_with_div.
+    struct market_data {
+        detail::name_map<double> spots;
+        detail::name_map<double> yields;                       ///< Continuous dividend yields
+        detail::name_map<std::vector<dividend>> dividends;     ///< Discrete schedules
+        detail::name_map<double> vols;
+        detail::name_map<rate_curve> curves;
+
+        /// @throws std::invalid_argument if name has no spot
+        double spot(std::string_view name) const { return detail::find(spots, name, "spot"); }
+
+        /// @throws std::invalid_argument if name has no volatility
+        double vol(std::string_view name) const { return detail::find(vols, name, "volatility"); }
+
+        /// @throws std::invalid_argument if there is no curve called name
+        const rate_curve& curve(std::string_view name) const { return detail::find(curves, name, "curve"); }
+
+        /// @return Continuous dividend yield of name, 0 if none is set
+        double dividend_yield(std::string_view name) const {
+            auto it = yields.find(name);
+            return it == yields.end() ? 0.0 : it->second;
+        }
+
+        /// Present value of the dividends of name paid in (0, tau]
+        /// @param name Instrument name (no schedule counts as no dividends)
+        /// @param discount Curve used to discount each payment
+        /// @param tau Horizon, e.g. the forward's maturity
+        /// @return Sum of amount * discount(time) over the payments in (0, tau]
+        double dividends_pv(std::string_view name, const rate_curve& discount, double tau) const {
+            auto it = dividends.find(name);
+            if (it == dividends.end()) return 0.0;
+            double pv = 0.0;
+            for (const dividend& d : it->second)
+                if (d.time > 0.0 && d.time <= tau) pv += d.amount * discount.discount(d.time);
+            return pv;
+        }
+    };
+
+    /// Options for MarketDataStore
+    struct market_data_options {
+        std::size_t max_readers = 64;  ///< Reader handles that may exist at once
+    };
+
+    /// Versioned market data published by writers and read lock-free by pricing threads
+    ///
+    /// Each publish() builds an immutable snapshot and swaps it in with one atomic pointer
+    /// exchange, so a reader sees either the old set or the new one, never a mix. Readers
+    /// take a reader handle once per thread and then open a guard per read: the guard
+    /// announces the current epoch in the handle's own cache line and loads the snapshot
+    /// pointer, two atomic operations and no lock, wait or allocation.
+    ///
+    /// Retired snapshots are freed by epoch-based reclamation: publish() bumps the epoch and
+    /// frees every retired snapshot older than the oldest epoch still announced by a guard.
+    /// Writers never wait for readers either; a snapshot held by a slow reader is freed by a
+    /// later publish() or reclaim(). Writers are serialised among themselves by a mutex that
+    /// readers never touch.
+    ///
+    /// Reader handles and guards must not outlive the store.
+    class MarketDataStore {
+        struct version_node {
+            market_data data;
+            std::uint64_t version = 0;
+            std::uint64_t retired = 0;  ///< Epoch at which it was replaced
+        };
+
+        struct alignas(64) slot {
+            std::atomic<std::uint64_t> epoch{0};  ///< Epoch announced by an open guard, 0 = none
+            std::atomic<bool> owned{false};
+        };
+
+    public:
+        /// Read access to the snapshot current when it was opened; cheap to open, keep it short
+        class guard {
+        public:
+            guard(const guard&) = delete;
+            guard& operator=(const guard&) = delete;
+            ~guard() { slot_->epoch.store(0, std::memory_order_release); }
+
+            const market_data& operator*() const { return node_->data; }
+            const market_data* operator->() const { return &node_->data; }
+
+            /// @return Number of the publish() that produced this snapshot (0 = initial)
+            std::uint64_t version() const { return node_->version; }
+
+        private:
+            friend class MarketDataStore;
+            guard(slot* s, const version_node* n) : slot_(s), node_(n) {}
+
+            slot* slot_;
+            const version_node* node_;
+        };
+
+        /// Per-thread read handle owning one reader slot
+        class reader {
+        public:
+            reader(reader&& other) noexcept : store_(std::exchange(other.store_, nullptr)), slot_(other.slot_) {}
+            reader& operator=(reader&&) = delete;
+            ~reader() {
+                if (store_) slot_->owned.store(false, std::memory_order_release);
+            }
+
+            /// Open a read of the current snapshot
+            /// @return Guard that keeps the snapshot alive until it is destroyed
+            /// @throws std::logic_error if a guard from this handle is still open
+            guard read() const {
+                if (slot_->epoch.load(std::memory_order_relaxed) != 0)
+                    throw std::logic_error("reader already has an open guard");
+                // seq_cst: the announcement must be visible before the pointer is loaded, or a
+                // writer scanning the slots could free the snapshot this guard is about to use
+                slot_->epoch.store(store_->epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                return guard(slot_, store_->current_.load(std::memory_order_seq_cst));
+            }
+
+        private:
+            friend class MarketDataStore;
+            reader(MarketDataStore* store, slot* s) : store_(store), slot_(s) {}
+
+            MarketDataStore* store_;
+            slot* slot_;
+        };
+
+        /// @param initial First snapshot (version 0)
+        /// @param options Reader limit
+        /// @throws std::invalid_argument if options.max_readers is 0
+        explicit MarketDataStore(market_data initial = {}, market_data_options options = {})
+            : slots_(options.max_readers) {
+            if (options.max_readers == 0) throw std::invalid_argument("max_readers must be positive");
+            current_.store(new version_node{std::move(initial), 0, 0});
+        }
+
+        MarketDataStore(const MarketDataStore&) = delete;
+        MarketDataStore& operator=(const MarketDataStore&) = delete;
+
+        ~MarketDataStore() {
+            delete current_.load();
+            for (version_node* n : retired_) delete n;
+        }
+
+        /// Claim a reader slot, typically once per pricing thread
+        /// @return Handle that releases its slot when destroyed
+        /// @throws std::length_error if max_readers handles already exist
+        reader make_reader() {
+            for (slot& s : slots_) {
+                bool expected = false;
+                if (!s.owned.load(std::memory_order_relaxed)
+                    && s.owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return reader(this, &s);
+            }
+            throw std::length_error("all " + std::to_string(slots_.size()) + " market data reader slots are in use");
+        }
+
+        /// Replace the current snapshot
+        /// @param next New market data
+        /// @return Version number of the new snapshot
+        std::uint64_t publish(market_data next) {
+            FINCRAFTR_PROBE("market::MarketDataStore::publish", 1);
+            auto node = std::make_unique<version_node>();
+            node->data = std::move(next);
+            std::lock_guard<std::mutex> lock(writer_);
+            return swap_in(std::move(node));
+        }
+
+        /// Publish a modified copy of the current snapshot, e.g. one updated spot
+        /// @param edit Callable taking market_data& to change in place
+        /// @return Version number of the new snapshot
+        /// @throws Whatever edit throws, in which case nothing is published
+        template <class Edit>
+        std::uint64_t update(Edit&& edit) {
+            FINCRAFTR_PROBE("market::MarketDataStore::update", 1);
+            std::lock_guard<std::mutex> lock(writer_);
+            auto node = std::make_unique<version_node>();
+            node->data = current_.load(std::memory_order_relaxed)->data;
+            std::forward<Edit>(edit)(node->data);
+            return swap_in(std::move(node));
+        }
+
+        /// Free retired snapshots that no open guard can still see
+        /// @return Number of snapshots still waiting for readers
+        std::size_t reclaim() {
+            std::lock_guard<std::mutex> lock(writer_);
+            collect();
+            return retired_.size();
+        }
+
+        /// @return Version number of the current snapshot
+        std::uint64_t version() const { return published_.load(std::memory_order_acquire); }
+
+    private:
+        std::uint64_t swap_in(std::unique_ptr<version_node> node) {
+            const std::uint64_t node_version = published_.load(std::memory_order_relaxed) + 1;
+            node->version = node_version;
+            version_node* old = current_.exchange(node.release(), std::memory_order_seq_cst);
+            // Guards announcing the new epoch started after the exchange and cannot hold old
+            old->retired = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+            retired_.push_back(old);
+            published_.store(node_version, std::memory_order_release);
+            collect();
+            return node_version;
+        }
+
+        void collect() {
+            std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+            for (const slot& s : slots_) {
+                const std::uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+                if (e != 0) oldest = std::min(oldest, e);
+            }
+            std::erase_if(retired_, [oldest](version_node* n) {
+                if (n->retired > oldest) return false;
+                delete n;
+                return true;
+            });
+        }
+
+        std::atomic<version_node*> current_{nullptr};
+        std::atomic<std::uint64_t> epoch_{1};
+        std::vector<slot> slots_;
+        std::mutex writer_;
+        std::vector<version_node*> retired_;  ///< Guarded by writer_
+        std::atomic<std::uint64_t> published_{0};
+    };
+}
@@ -0,0 +1,570 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "trace.hpp"
+
+namespace fc::parallel {
+    /// Number of worker threads used when a caller passes threads = 0
+    /// @return Hardware concurrency, or 1 if it cannot be determined
+    inline unsigned default_threads() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1u : n;
+    }
+
+    /// Size and placement of a thread_pool
+    struct pool_options {
+        unsigned workers = 0;        ///< Worker threads, 0 = max(1, default_threads() - 1)
+        bool pin = false;            ///< Pin each worker to one CPU (Linux only, ignored elsewhere)
+        std::vector<unsigned> cpus;  ///< CPUs for pinned workers, worker i on cpus[i % size]; empty = CPU i
+    };
+
+    namespace detail {
+        /// Bytes a task can hold inline; larger callables are boxed on the heap
+        inline constexpr std::size_t task_storage = 112;
+
+        /// Type-erased unit of work; invoke() runs the callable, destroys it and frees the task
+        struct alignas(64) task {
+            void (*invoke)(task*) = nullptr;
+            task* next = nullptr;  ///< Free-list link while unused
+            alignas(std::max_align_t) unsigned char storage[task_storage];
+        };
+
+        /// Per-thread free list of tasks
+        ///
+        /// Tasks are carved from blocks of 64 owned by a process-wide registry. A thread that
+        /// frees more tasks than it allocates (a worker running tasks submitted elsewhere) hands
+        /// the surplus back to the shared list, and a thread that runs dry refills from it, so
+        /// the steady state allocates nothing and takes the shared lock once per 64 tasks.
+        class task_arena {
+        public:
+            static task_arena& local() {
+                thread_local task_arena arena;
+                return arena;
+            }
+
+            task_arena() = default;
+            task_arena(const task_arena&) = delete;
+            task_arena& operator=(const task_arena&) = delete;
+            ~task_arena() { give_back(count_); }
+
+            task* allocate() {
+                if (!free_) refill();
+                task* t = free_;
+                free_ = t->next;
+                --count_;
+                return t;
+            }
+
+            void release(task* t) noexcept {
+                t->next = free_;
+                free_ = t;
+                if (++count_ > 4 * block) give_back(2 * block);
+            }
+
+        private:
+            static constexpr std::size_t block = 64;
+
+            struct shared_list {
+                std::mutex mutex;
+                task* free = nullptr;
+                std::size_t count = 0;
+                std::vector<std::unique_ptr<task[]>> blocks;
+            };
+
+            // Never destroyed: thread_local arenas of worker threads return their tasks here
+            // while static destructors, including the shared pool's, are running
+            static shared_list& shared() {
+                static shared_list* list = new shared_list;
+                return *list;
+            }
+
+            void refill() {
+                shared_list& s = shared();
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.free) {
+                    auto fresh = std::make_unique<task[]>(block);
+                    for (std::size_t i = 0; i < block; ++i) {
+                        fresh[i].next = s.free;
+                        s.free = &fresh[i];
+                    }
+                    s.count += block;
+                    s.blocks.push_back(std::move(fresh));
+                }
+                for (std::size_t i = 0; i < block && s.free; ++i) {
+                    task* t = s.free;
+                    s.free = t->next;
+                    --s.count;
+                    t->next = free_;
+                    free_ = t;
+                    ++count_;
+                }
+            }
+
+            void give_back(std::size_t n) noexcept {
+                if (n == 0 || !free_) return;
+                task* first = free_;
+                task* last = free_;
+                std::size_t moved = 1;
+                while (moved < n && last->next) {
+                    last = last->next;
+                    ++moved;
+                }
+                free_ = last->next;
+                count_ -= moved;
+                shared_list& s = shared();
+                std::lock_guard<std::mutex> lock(s.mutex);
+                last->next = s.free;
+                s.free = first;
+                s.count += moved;
+            }
+
+            task* free_ = nullptr;
+            std::size_t count_ = 0;
+        };
+
+        template <class F>
+        task* make_task(F&& f) {
+            using Fn = std::decay_t<F>;
+            task* t = task_arena::local().allocate();
+            if constexpr (sizeof(Fn) <= task_storage && alignof(Fn) <= alignof(std::max_align_t)) {
+                try {
+                    ::new (static_cast<void*>(t->storage)) Fn(std::forward<F>(f));
+                } catch (...) {
+                    task_arena::local().release(t);
+                    throw;
+                }
+                t->invoke = [](task* self) {
+                    Fn* fn = std::launder(reinterpret_cast<Fn*>(self->storage));
+                    struct cleanup {
+                        Fn* fn;
+                        task* self;
+                        ~cleanup() {
+                            fn->~Fn();
+                            task_arena::local().release(self);
+                        }
+                    } c{fn, self};
+                    (*fn)();
+                };
+            } else {
+                Fn* boxed;
+                try {
+                    boxed = new Fn(std::forward<F>(f));
+                } catch (...) {
+                    task_arena::local().release(t);
+                    throw;
+                }
+                ::new (static_cast<void*>(t->storage)) Fn*(boxed);
+                t->invoke = [](task* self) {
+                    struct cleanup {
+                        Fn* fn;
+                        task* self;
+                        ~cleanup() {
+                            delete fn;
+                            task_arena::local().release(self);
+                        }
+                    } c{*std::launder(reinterpret_cast<Fn**>(self->storage)), self};
+                    (*c.fn)();
+                };
+            }
+            return t;
+        }
+
+        /// Chase-Lev work-stealing deque of tasks
+        ///
+        /// The owning worker pushes and pops at the bottom, other threads steal from the top.
+        /// The ring grows when full; replaced rings are kept until the deque is destroyed
+        /// because a thief may still be reading one.
+        class work_deque {
+            struct ring {
+                explicit ring(std::size_t size) : mask(size - 1), slots(new std::atomic<task*>[size]) {}
+                task* get(std::int64_t i) const { return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed); }
+                void put(std::int64_t i, task* t) { slots[static_cast<std::size_t>(i) & mask].store(t, std::memory_order_relaxed); }
+
+                std::size_t mask;
+                std::unique_ptr<std::atomic<task*>[]> slots;
+            };
+
+        public:
+            work_deque() : ring_(new ring(256)) {}
+            work_deque(const work_deque&) = delete;
+            work_deque& operator=(const work_deque&) = delete;
+            ~work_deque() { delete ring_.load(std::memory_order_relaxed); }
+
+            /// Owner only
+            void push(task* t) {
+                const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+                const std::int64_t top = top_.load(std::memory_order_acquire);
+                ring* r = ring_.load(std::memory_order_relaxed);
+                if (b - top > static_cast<std::int64_t>(r->mask)) r = grow(r, top, b);
+                r->put(b, t);
+                bottom_.store(b + 1, std::memory_order_release);
+            }
+
+            /// Owner only
+            /// @return Most recently pushed task, or nullptr if empty
+            task* pop() {
+                const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+                ring* r = ring_.load(std::memory_order_relaxed);
+                bottom_.store(b, std::memory_order_seq_cst);
+                std::int64_t top = top_.load(std::memory_order_seq_cst);
+                if (top > b) {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                task* t = r->get(b);
+                if (top == b) {
+                    // Last task: race the thieves for it
+                    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        t = nullptr;
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+                return t;
+            }
+
+            /// Any thread
+            /// @return Oldest task, or nullptr if empty or another thread won it
+            task* steal() {
+                std::int64_t top = top_.load(std::memory_order_seq_cst);
+                const std::int64_t b = bottom_.load(std::memory_order_seq_cst);
+                if (top >= b) return nullptr;
+                task* t = ring_.load(std::memory_order_acquire)->get(top);
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    return nullptr;
+                return t;
+            }
+
+            bool empty() const {
+                return top_.load(std::memory_order_seq_cst) >= bottom_.load(std::memory_order_seq_cst);
+            }
+
+        private:
+            ring* grow(ring* old, std::int64_t top, std::int64_t b) {
+                auto bigger = std::make_unique<ring>(2 * (old->mask + 1));
+                for (std::int64_t i = top; i < b; ++i) bigger->put(i, old->get(i));
+                retired_.emplace_back(old);
+                ring_.store(bigger.get(), std::memory_order_release);
+                return bigger.release();
+            }
+
+            alignas(64) std::atomic<std::int64_t> top_{0};
+            alignas(64) std::atomic<std::int64_t> bottom_{0};
+            std::atomic<ring*> ring_;
+            std::vector<std::unique_ptr<ring>> retired_;  ///< Owner only
+        };
+
+        /// Pool and index of the worker running on this thread, if any
+        struct worker_identity {
+            const void* pool = nullptr;
+            unsigned index = 0;
+        };
+        inline thread_local worker_identity current_worker;
+
+        struct shared_pool_config {
+            std::mutex mutex;
+            pool_options options;
+            bool started = false;
+        };
+
+        inline shared_pool_config& shared_config() {
+            static shared_pool_config config;
+            return config;
+        }
+
+        /// Best effort: a CPU that does not exist or is not allowed leaves the thread unpinned
+        inline void pin_current_thread([[maybe_unused]] unsigned cpu) {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu % CPU_SETSIZE, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+        }
+    }
+
+    /// Work-stealing pool of native worker threads shared by all parallel library paths
+    ///
+    /// Every worker owns a Chase-Lev deque: tasks submitted from a worker go to the bottom of
+    /// its own deque and run there most-recent-first, while idle workers steal the oldest task
+    /// of a random victim. Tasks submitted from other threads go through a shared injection
+    /// queue. Tasks live in per-thread arenas, so submitting allocates nothing once warm
+    /// (callables up to detail::task_storage bytes are stored inline).
+    ///
+    /// Because a worker that waits on nested work keeps running tasks instead of blocking
+    /// (see wait_until() and parallel_for), nested parallel calls, e.g. a parallel loop over
+    /// portfolios whose bodies run parallel loops over scenarios, share the same fixed set of
+    /// threads rather than multiplying them.
+    class thread_pool {
+    public:
+        /// @return The shared pool, started on first use with the options given to configure()
+        static thread_pool& instance() {
+            static thread_pool pool([] {
+                detail::shared_pool_config& config = detail::shared_config();
+                std::lock_guard<std::mutex> lock(config.mutex);
+                config.started = true;
+                return config.options;
+            }());
+            return pool;
+        }
+
+        /// Set the size and pinning of the shared pool
+        /// @param options Options used when instance() first starts the pool
+        /// @throws std::logic_error if the shared pool has already started
+        static void configure(pool_options options) {
+            detail::shared_pool_config& config = detail::shared_config();
+            std::lock_guard<std::mutex> lock(config.mutex);
+            if (config.started) throw std::logic_error("fc::parallel::thread_pool::configure called after the shared pool started");
+            config.options = std::move(options);
+        }
+
+        /// @param workers Worker threads (0 = max(1, default_threads() - 1))
+        explicit thread_pool(unsigned workers) : thread_pool(pool_options{workers, false, {}}) {}
+
+        /// @param options Worker count and CPU pinning
+        explicit thread_pool(pool_options options) {
+            const unsigned workers = options.workers != 0 ? options.workers : std::max(1u, default_threads() - 1);
+            workers_.reserve(workers);
+            for (unsigned i = 0; i < workers; ++i) workers_.push_back(std::make_unique<worker>());
+            // Start the threads only once every deque exists, since they steal from each other
+            for (unsigned i = 0; i < workers; ++i) {
+                const bool pin = options.pin;
+                const unsigned cpu = options.cpus.empty() ? i : options.cpus[i % options.cpus.size()];
+                workers_[i]->thread = std::thread([this, i, pin, cpu] {
+                    fc::trace::set_thread_name("fincraftr worker " + std::to_string(i));
+                    if (pin) detail::pin_current_thread(cpu);
+                    work(i);
+                });
+            }
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+                stop_.store(true, std::memory_order_relaxed);
+            }
+            sleep_cv_.notify_all();
+            for (auto& w : workers_) w->thread.join();
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /// @return Number of worker threads owned by the pool
+        unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+        /// @return Whether the calling thread is one of this pool's workers
+        bool on_worker() const { return detail::current_worker.pool == this; }
+
+        /// Queue a task for execution on a worker
+        /// @param f Callable invoked as f(); it must not throw
+        template <class F>
+        void submit(F&& f) {
+            detail::task* t = detail::make_task(std::forward<F>(f));
+            if (on_worker()) {
+                workers_[detail::current_worker.index]->deque.push(t);
+            } else {
+                std::lock_guard<std::mutex> lock(inject_mutex_);
+                injected_.push_back(t);
+                injected_count_.fetch_add(1, std::memory_order_release);
+            }
+            wake();
+        }
+
+        /// Run queued tasks on the calling worker until done() returns true
+        /// @param done Predicate polled between tasks
+        /// @note Must be called on one of this pool's workers (see on_worker()).
+        template <class Done>
+        void wait_until(Done&& done) {
+            const unsigned self = detail::current_worker.index;
+            while (!done()) {
+                if (detail::task* t = find_task(self)) t->invoke(t);
+                else std::this_thread::yield();
+            }
+        }
+
+    private:
+        struct worker {
+            detail::work_deque deque;
+            std::thread thread;
+        };
+
+        void work(unsigned index) {
+            detail::current_worker = {this, index};
+            for (;;) {
+                detail::task* t = find_task(index);
+                for (int spin = 0; !t && spin < 64; ++spin) {
+                    std::this_thread::yield();
+                    t = find_task(index);
+                }
+                if (t) {
+                    t->invoke(t);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                // Announce before the final check. submit() reads sleepers_ with a read-modify-
+                // write after publishing its task, so either it sees this increment or this
+                // thread's increment reads from it and the check below sees the task
+                sleepers_.fetch_add(1, std::memory_order_acq_rel);
+                while (!stop_.load(std::memory_order_relaxed) && !has_work()) sleep_cv_.wait(lock);
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                if (stop_.load(std::memory_order_relaxed) && !has_work()) return;
+            }
+        }
+
+        detail::task* find_task(unsigned self) {
+            if (self < workers_.size() && detail::current_worker.pool == this)
+                if (detail::task* t = workers_[self]->deque.pop()) return t;
+
+            if (injected_count_.load(std::memory_order_acquire) != 0) {
+                std::lock_guard<std::mutex> lock(inject_mutex_);
+                if (!injected_.empty()) {
+                    detail::task* t = injected_.front();
+                    injected_.pop_front();
+                    injected_count_.fetch_sub(1, std::memory_order_relaxed);
+                    return t;
+                }
+            }
+
+            const std::size_t n = workers_.size();
+            thread_local std::uint32_t seed = 0x9e3779b9u ^ static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            const std::size_t start = seed % n;
+            for (std::size_t k = 0; k < n; ++k) {
+                const std::size_t victim = (start + k) % n;
+                if (victim == self && detail::current_worker.pool == this) continue;
+                if (detail::task* t = workers_[victim]->deque.steal()) return t;
+            }
+            return nullptr;
+        }
+
+        bool has_work() const {
+            if (injected_count_.load(std::memory_order_seq_cst) != 0) return true;
+            for (const auto& w : workers_)
+                if (!w->deque.empty()) return true;
+            return false;
+        }
+
+        void wake() {
+            if (sleepers_.fetch_add(0, std::memory_order_acq_rel) == 0) return;
+            // Taking the lock orders the notify after a sleeper's final check
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.notify_one();
+        }
+
+        std::vector<std::unique_ptr<worker>> workers_;
+
+        std::mutex inject_mutex_;
+        std::deque<detail::task*> injected_;
+        std::atomic<std::size_t> injected_count_{0};
+
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
+        std::atomic<unsigned> sleepers_{0};
+        std::atomic<bool> stop_{false};
+    };
+
+    /// Run body(begin, end) over [0, n) split into chunks of at most grain items
+    /// @param n Number of items
+    /// @param grain Maximum chunk size handed to a single body call (must be > 0)
+    /// @param threads Number of threads to use (0 selects default_threads())
+    /// @param body Callable invoked as body(std::size_t begin, std::size_t end)
+    /// @throws Rethrows the first exception raised by any body call
+    /// @note Chunks are claimed dynamically, so uneven work per item balances out.
+    ///       The calling thread participates as one of the workers, and helpers that have
+    ///       not started by the time it runs out of chunks are skipped. Called from a body
+    ///       (or any other pool task), the helpers go to the calling worker's own deque and
+    ///       the wait for running helpers executes other tasks, so nested calls neither block
+    ///       a worker nor add threads.
+    template <class Body>
+    void parallel_for(std::size_t n, std::size_t grain, unsigned threads, Body&& body) {
+        if (n == 0) return;
+        if (grain == 0) grain = 1;
+        if (threads == 0) threads = default_threads();
+        const std::size_t chunks = (n + grain - 1) / grain;
+        const unsigned workers = static_cast<unsigned>(std::min<std::size_t>(threads, chunks));
+        if (workers <= 1) {
+            for (std::size_t b = 0; b < n; b += grain) body(b, std::min(n, b + grain));
+            return;
+        }
+
+        struct shared_state {
+            std::atomic<std::size_t> next{0};
+            std::atomic<unsigned> active{0};
+            std::atomic<bool> closed{false};
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+        auto state = std::make_shared<shared_state>();
+
+        auto run = [state, chunks, grain, n, &body]() {
+            FINCRAFTR_TRACE_SPAN("parallel_for", n);
+            for (;;) {
+                std::size_t c = state->next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks) return;
+                std::size_t b = c * grain;
+                try {
+                    body(b, std::min(n, b + grain));
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->next.store(chunks, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        };
+
+        thread_pool& pool = thread_pool::instance();
+        const unsigned helpers = std::min(workers - 1, pool.size());
+        for (unsigned t = 0; t < helpers; ++t) {
+            pool.submit([state, run]() {
+                // seq_cst pairs with closed/active in the caller: either the caller waits for
+                // this helper or the helper sees closed and never touches body
+                state->active.fetch_add(1, std::memory_order_seq_cst);
+                if (!state->closed.load(std::memory_order_seq_cst)) run();
+                if (state->active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->done.notify_all();
+                }
+            });
+        }
+        run();
+
+        state->closed.store(true, std::memory_order_seq_cst);
+        if (pool.on_worker()) {
+            pool.wait_until([&] { return state->active.load(std::memory_order_seq_cst) == 0; });
+        } else {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->done.wait(lock, [&] { return state->active.load(std::memory_order_seq_cst) == 0; });
+        }
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            error = std::move(state->error);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+}
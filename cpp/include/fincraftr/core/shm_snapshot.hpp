@@ -0,0 +1,369 @@
+#pragma once
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define FINCRAFTR_HAS_SHM 1
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fc::shm {
+    /// Maximum number of dimensions of a snapshot array
+    inline constexpr std::size_t max_ndim = 4;
+
+    namespace detail {
+        inline constexpr char magic[8] = {'F', 'C', 'S', 'N', 'A', 'P', '0', '1'};
+        inline constexpr std::size_t alignment = 64;
+        inline constexpr std::size_t max_name = 56;
+
+        /// Control segment /<base>: the version readers should attach to (0 = none yet)
+        struct control {
+            std::uint64_t version;
+        };
+
+        /// Start of a data segment /<base>.<version>, followed by `count` entries and the data
+        struct header {
+            char magic[8];
+            std::uint64_t version;
+            std::uint64_t count;
+            std::uint64_t size;
+        };
+
+        struct entry {
+            char name[max_name];
+            std::uint64_t offset;      // from the start of the segment, aligned to 64 bytes
+            std::uint64_t ndim;
+            std::uint64_t shape[max_ndim];
+        };
+
+        using atomic_version = std::atomic_ref<std::uint64_t>;
+        static_assert(atomic_version::is_always_lock_free, "shared snapshot versions need lock-free 64-bit atomics");
+
+        inline std::size_t align(std::size_t n) { return (n + alignment - 1) / alignment * alignment; }
+
+        /// Number of elements of an array of the given shape, or std::nullopt on overflow
+        template <class Dim>
+        inline std::optional<std::size_t> element_count(const Dim* shape, std::size_t ndim) {
+            for (std::size_t d = 0; d < ndim; ++d)
+                if (shape[d] == 0) return 0;
+            std::size_t count = 1;
+            for (std::size_t d = 0; d < ndim; ++d) {
+                if (shape[d] > std::numeric_limits<std::size_t>::max() / count) return std::nullopt;
+                count *= static_cast<std::size_t>(shape[d]);
+            }
+            return count;
+        }
+
+        [[noreturn]] inline void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        inline std::string control_name(const std::string& base) { return "/" + base; }
+
+        inline std::string segment_name(const std::string& base, std::uint64_t version) {
+            return "/" + base + "." + std::to_string(version);
+        }
+
+        inline void check_base(const std::string& base) {
+            if (base.empty() || base.size() > 200 || base.find('/') != std::string::npos)
+                throw std::invalid_argument("snapshot name must be non-empty, short and contain no '/'");
+        }
+
+        /// Owned mmap of a shared memory object, unmapped on destruction
+        class mapping {
+        public:
+            mapping(const std::string& name, int flags, std::size_t size = 0) {
+                const int fd = ::shm_open(name.c_str(), flags, 0644);
+                if (fd < 0) fail("shm_open");
+                if (size != 0 && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                    ::close(fd);
+                    fail("ftruncate");
+                }
+                if (size == 0) {
+                    struct stat st {};
+                    if (::fstat(fd, &st) != 0) {
+                        ::close(fd);
+                        fail("fstat");
+                    }
+                    size = static_cast<std::size_t>(st.st_size);
+                }
+                if (size == 0) {  // created but not sized yet; callers reject it as too small
+                    ::close(fd);
+                    return;
+                }
+                const int prot = (flags & O_ACCMODE) == O_RDONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+                void* p = ::mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (p == MAP_FAILED) fail("mmap");
+                data_ = static_cast<std::byte*>(p);
+                size_ = size;
+            }
+
+            ~mapping() {
+                if (data_) ::munmap(data_, size_);
+            }
+
+            mapping(const mapping&) = delete;
+            mapping& operator=(const mapping&) = delete;
+
+            std::byte* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            std::byte* data_ = nullptr;
+            std::size_t size_ = 0;
+        };
+
+        inline std::uint64_t load_version(const mapping& control) {
+            return atomic_version(reinterpret_cast<detail::control*>(control.data())->version)
+                .load(std::memory_order_acquire);
+        }
+    }
+
+    /// Builds market-data snapshots and publishes them into POSIX shared memory
+    ///
+    /// Each publish() writes a new segment /<base>.<version> (a header, a directory of named
+    /// float64 arrays, then the 64-byte aligned data) and only then stores the new version
+    /// into the control segment /<base> with release ordering. Readers that attach afterwards
+    /// see the complete segment; readers still mapping an older version keep it until they
+    /// detach. The last `keep` versions stay linked so a reader that has just read the
+    /// version can still open it. A base name must have a single writer at a time.
+    class snapshot_writer {
+    public:
+        /// @param base Snapshot name shared with readers (no '/')
+        /// @param keep Number of most recent versions left linked (at least 1)
+        /// @throws std::invalid_argument if base is not a valid name
+        /// @throws std::system_error if the control segment cannot be created
+        explicit snapshot_writer(std::string base, unsigned keep = 2)
+            : base_(std::move(base)), keep_(keep == 0 ? 1 : keep) {
+            detail::check_base(base_);
+            control_ = std::make_unique<detail::mapping>(detail::control_name(base_), O_RDWR | O_CREAT,
+                                                        sizeof(detail::control));
+        }
+
+        /// Stage an array for the next publish()
+        /// @param name Array name (at most 55 bytes, unique within the snapshot)
+        /// @param values Row-major values; must stay valid until publish() returns
+        /// @param shape Array shape (empty = one dimension of values.size())
+        /// @throws std::invalid_argument on a bad name or a shape that does not match values
+        /// @note Nothing is staged if this throws.
+        void add(std::string name, std::span<const double> values, std::vector<std::size_t> shape = {}) {
+            if (name.empty() || name.size() >= detail::max_name) throw std::invalid_argument("snapshot array name must be 1-55 bytes");
+            for (const staged& s : staged_)
+                if (s.name == name) throw std::invalid_argument("duplicate snapshot array name");
+            if (shape.empty()) shape.push_back(values.size());
+            if (shape.size() > max_ndim) throw std::invalid_argument("snapshot arrays have at most 4 dimensions");
+            if (detail::element_count(shape.data(), shape.size()) != values.size())
+                throw std::invalid_argument("snapshot array shape does not match its size");
+            staged_.push_back({std::move(name), values, std::move(shape)});
+        }
+
+        /// Drop the arrays staged since the last publish()
+        /// @note Call this when staging a set of arrays fails part-way, so the next publish()
+        ///       does not include the arrays already added (or read their released buffers).
+        void clear() noexcept { staged_.clear(); }
+
+        /// Write the staged arrays as the next version and make it current
+        /// @return The published version
+        /// @throws std::system_error if the segment cannot be created
+        /// @note Staged arrays are cleared afterwards, also if publishing fails.
+        std::uint64_t publish() {
+            std::vector<staged> arrays = std::move(staged_);
+            staged_.clear();
+
+            detail::atomic_version current(reinterpret_cast<detail::control*>(control_->data())->version);
+            const std::uint64_t version = current.load(std::memory_order_acquire) + 1;
+
+            std::size_t size = detail::align(sizeof(detail::header) + arrays.size() * sizeof(detail::entry));
+            std::vector<std::size_t> offsets;
+            offsets.reserve(arrays.size());
+            for (const staged& a : arrays) {
+                offsets.push_back(size);
+                size += detail::align(a.values.size_bytes());
+            }
+
+            const std::string name = detail::segment_name(base_, version);
+            ::shm_unlink(name.c_str());  // leftover from a writer that died before publishing
+            detail::mapping segment(name, O_RDWR | O_CREAT | O_EXCL, size);
+            std::byte* base = segment.data();
+
+            auto* h = reinterpret_cast<detail::header*>(base);
+            std::memcpy(h->magic, detail::magic, sizeof(h->magic));
+            h->version = version;
+            h->count = arrays.size();
+            h->size = size;
+            auto* entries = reinterpret_cast<detail::entry*>(base + sizeof(detail::header));
+            for (std::size_t k = 0; k < arrays.size(); ++k) {
+                detail::entry& e = entries[k];
+                std::memset(&e, 0, sizeof(e));
+                std::memcpy(e.name, arrays[k].name.data(), arrays[k].name.size());
+                e.offset = offsets[k];
+                e.ndim = arrays[k].shape.size();
+                for (std::size_t d = 0; d < e.ndim; ++d) e.shape[d] = arrays[k].shape[d];
+                if (!arrays[k].values.empty())
+                    std::memcpy(base + offsets[k], arrays[k].values.data(), arrays[k].values.size_bytes());
+            }
+
+            current.store(version, std::memory_order_release);
+            if (version > keep_) ::shm_unlink(detail::segment_name(base_, version - keep_).c_str());
+            return version;
+        }
+
+        /// Unlink the control segment and every version still linked
+        /// @note Processes that are attached keep their mappings.
+        void remove() {
+            const std::uint64_t version = detail::load_version(*control_);
+            for (std::uint64_t v = version > keep_ ? version - keep_ + 1 : 1; v <= version; ++v)
+                ::shm_unlink(detail::segment_name(base_, v).c_str());
+            ::shm_unlink(detail::control_name(base_).c_str());
+        }
+
+        /// @return Name passed at construction
+        const std::string& base() const { return base_; }
+
+    private:
+        struct staged {
+            std::string name;
+            std::span<const double> values;
+            std::vector<std::size_t> shape;
+        };
+
+        std::string base_;
+        unsigned keep_;
+        std::unique_ptr<detail::mapping> control_;
+        std::vector<staged> staged_;
+    };
+
+    /// Read-only view of one published snapshot version
+    ///
+    /// Arrays are spans into the shared mapping, so any number of processes read the same
+    /// physical pages without copying or parsing. The view stays valid, and its contents
+    /// unchanged, for the lifetime of the object even after newer versions are published.
+    class snapshot {
+    public:
+        /// Attach to the current version of a snapshot
+        /// @param base Snapshot name used by the writer
+        /// @return View of the newest complete version
+        /// @throws std::invalid_argument if base is invalid or nothing has been published
+        /// @throws std::system_error if the segments cannot be mapped (e.g. no writer created base)
+        /// @note If the writer retires the version between reading it and opening the
+        ///       segment, the attach retries with the newer version.
+        static snapshot attach(const std::string& base) {
+            detail::check_base(base);
+            auto control = std::make_shared<detail::mapping>(detail::control_name(base), O_RDONLY);
+            if (control->size() < sizeof(detail::control)) throw std::invalid_argument("not a fincraftr snapshot");
+            for (;;) {
+                const std::uint64_t version = detail::load_version(*control);
+                if (version == 0) throw std::invalid_argument("no snapshot has been published yet");
+                std::unique_ptr<detail::mapping> segment;
+                try {
+                    segment = std::make_unique<detail::mapping>(detail::segment_name(base, version), O_RDONLY);
+                } catch (const std::system_error& e) {
+                    if (e.code() == std::errc::no_such_file_or_directory && detail::load_version(*control) != version)
+                        continue;
+                    throw;
+                }
+                return snapshot(std::move(control), std::move(segment));
+            }
+        }
+
+        /// @return Version this view is attached to
+        std::uint64_t version() const { return header().version; }
+
+        /// @return Newest version published under the same name
+        std::uint64_t latest_version() const { return detail::load_version(*control_); }
+
+        /// @return True if a newer version has been published since this view attached
+        bool stale() const { return latest_version() != version(); }
+
+        /// @return Number of arrays in the snapshot
+        std::size_t size() const { return header().count; }
+
+        /// @param k Array position in [0, size())
+        /// @return Name of that array
+        std::string_view name(std::size_t k) const {
+            const detail::entry& e = entry_at(k);
+            return {e.name, ::strnlen(e.name, detail::max_name)};
+        }
+
+        /// @param name Array name
+        /// @return True if the snapshot holds an array of that name
+        bool contains(std::string_view name) const { return find(name) != nullptr; }
+
+        /// @param name Array name
+        /// @return Flattened row-major values of the array
+        /// @throws std::invalid_argument if there is no such array
+        std::span<const double> operator[](std::string_view name) const {
+            const detail::entry& e = get(name);
+            return {reinterpret_cast<const double*>(segment_->data() + e.offset), *detail::element_count(e.shape, e.ndim)};
+        }
+
+        /// @param name Array name
+        /// @return Shape of the array
+        /// @throws std::invalid_argument if there is no such array
+        std::vector<std::size_t> shape(std::string_view name) const {
+            const detail::entry& e = get(name);
+            return std::vector<std::size_t>(e.shape, e.shape + e.ndim);
+        }
+
+    private:
+        snapshot(std::shared_ptr<detail::mapping> control, std::unique_ptr<detail::mapping> segment)
+            : control_(std::move(control)), segment_(std::move(segment)) {
+            const std::size_t n = segment_->size();
+            if (n < sizeof(detail::header) || std::memcmp(header().magic, detail::magic, sizeof(detail::magic)) != 0
+                || header().size > n || header().count > (n - sizeof(detail::header)) / sizeof(detail::entry))
+                throw std::invalid_argument("corrupt fincraftr snapshot segment");
+            // Entries come from another process: bound ndim before reading shape, and keep the
+            // size arithmetic from wrapping
+            for (std::size_t k = 0; k < size(); ++k) {
+                const detail::entry& e = entry_at(k);
+                if (e.ndim > max_ndim || e.offset % detail::alignment != 0 || e.offset > n)
+                    throw std::invalid_argument("corrupt fincraftr snapshot segment");
+                const std::optional<std::size_t> count = detail::element_count(e.shape, e.ndim);
+                if (!count || *count > (n - e.offset) / sizeof(double))
+                    throw std::invalid_argument("corrupt fincraftr snapshot segment");
+            }
+        }
+
+        const detail::header& header() const { return *reinterpret_cast<const detail::header*>(segment_->data()); }
+
+        const detail::entry& entry_at(std::size_t k) const {
+            if (k >= size()) throw std::invalid_argument("snapshot array index out of range");
+            return reinterpret_cast<const detail::entry*>(segment_->data() + sizeof(detail::header))[k];
+        }
+
+        const detail::entry* find(std::string_view name) const {
+            for (std::size_t k = 0; k < size(); ++k)
+                if (this->name(k) == name) return &entry_at(k);
+            return nullptr;
+        }
+
+        const detail::entry& get(std::string_view name) const {
+            const detail::entry* e = find(name);
+            if (!e) throw std::invalid_argument("no snapshot array named " + std::string(name));
+            return *e;
+        }
+
+        std::shared_ptr<detail::mapping> control_;
+        std::unique_ptr<detail::mapping> segment_;
+    };
+}
+
+#endif
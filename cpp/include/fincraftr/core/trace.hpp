@@ -0,0 +1,284 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+#ifndef FINCRAFTR_TRACE_BUFFER_EVENTS
+#define FINCRAFTR_TRACE_BUFFER_EVENTS (1u << 15)
+#endif
+
+/// Timeline tracing of batch pipelines in Chrome trace format
+///
+/// Batch entry points (fc::batch::map, parallel_for workers, the compiled kernels and the
+/// engines) open a span when tracing is active. Each thread appends finished spans to its
+/// own fixed-size ring buffer without locks, overwriting its oldest spans when full, and
+/// write_chrome_json() / dump() export every buffer as Chrome trace JSON that loads in
+/// chrome://tracing or ui.perfetto.dev, one track per thread. Applications add their own
+/// stages with fc::trace::span so library work shows up inside them.
+///
+/// While tracing is stopped a span costs one relaxed atomic load. Define FINCRAFTR_NO_TRACE
+/// to remove the library's own spans at compile time.
+namespace fc::trace {
+    /// Spans kept per thread before the oldest are overwritten (power of two)
+    inline constexpr std::size_t buffer_events = FINCRAFTR_TRACE_BUFFER_EVENTS;
+    static_assert((buffer_events & (buffer_events - 1)) == 0 && buffer_events > 0,
+                  "FINCRAFTR_TRACE_BUFFER_EVENTS must be a power of two");
+
+    namespace detail {
+        inline std::atomic<bool> active{false};
+        inline std::atomic<std::int64_t> epoch_ns{0};
+
+        /// One finished span; fields are atomics so a concurrent export never reads a torn
+        /// value, and relaxed stores compile to plain moves
+        struct slot {
+            std::atomic<const char*> name{nullptr};
+            std::atomic<std::uint64_t> begin{0}, end{0}, arg{0};
+        };
+
+        /// Single-producer ring: only the owning thread writes, exporters read
+        struct buffer {
+            std::unique_ptr<slot[]> slots{new slot[buffer_events]};
+            std::atomic<std::uint64_t> head{0};  ///< Spans ever written
+            std::uint32_t tid = 0;
+            std::string thread_name;             ///< Guarded by registry::mutex
+            bool exited = false;                 ///< Guarded by registry::mutex
+
+            void push(const char* name, std::uint64_t begin, std::uint64_t end, std::uint64_t arg) noexcept {
+                const std::uint64_t h = head.load(std::memory_order_relaxed);
+                slot& s = slots[h & (buffer_events - 1)];
+                s.name.store(name, std::memory_order_relaxed);
+                s.begin.store(begin, std::memory_order_relaxed);
+                s.end.store(end, std::memory_order_relaxed);
+                s.arg.store(arg, std::memory_order_relaxed);
+                head.store(h + 1, std::memory_order_release);
+            }
+        };
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<buffer>> buffers;
+            std::uint32_t next_tid = 1;
+            std::unordered_set<std::string> names;  ///< Interned span names
+
+            static registry& instance() {
+                static registry* r = new registry;  // leaked: spans may close during static destruction
+                return *r;
+            }
+        };
+
+        /// Calling thread's buffer, created on its first span
+        struct thread_slot {
+            std::shared_ptr<buffer> buf;
+            std::string name;
+
+            buffer& get() {
+                if (!buf) {
+                    auto b = std::make_shared<buffer>();
+                    registry& r = registry::instance();
+                    std::lock_guard<std::mutex> lock(r.mutex);
+                    b->tid = r.next_tid++;
+                    b->thread_name = name;
+                    r.buffers.push_back(b);
+                    buf = std::move(b);
+                }
+                return *buf;
+            }
+
+            ~thread_slot() {
+                if (!buf) return;
+                registry& r = registry::instance();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                buf->exited = true;
+            }
+        };
+
+        inline thread_slot& local() {
+            thread_local thread_slot slot;
+            return slot;
+        }
+
+        inline void write_escaped(std::ostream& os, std::string_view s) {
+            for (char c : s) {
+                if (c == '"' || c == '\\') os << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) os << ' ';
+                else os << c;
+            }
+        }
+    }
+
+    /// @return Nanoseconds on the trace clock (steady_clock, relative to the last start())
+    inline std::uint64_t now() noexcept {
+        const std::int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        return static_cast<std::uint64_t>(std::max<std::int64_t>(0, t - detail::epoch_ns.load(std::memory_order_relaxed)));
+    }
+
+    /// @return True between start() and stop()
+    inline bool active() noexcept { return detail::active.load(std::memory_order_relaxed); }
+
+    /// Drop every recorded span and forget threads that have exited
+    /// @note Call while no thread is recording (e.g. after stop()); spans closing concurrently
+    ///       may survive the clear
+    inline void clear() {
+        detail::registry& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::erase_if(r.buffers, [](const std::shared_ptr<detail::buffer>& b) { return b->exited; });
+        for (auto& b : r.buffers) b->head.store(0, std::memory_order_relaxed);
+    }
+
+    /// Clear previous spans, restart the trace clock and begin recording
+    inline void start() {
+        clear();
+        detail::epoch_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+        detail::active.store(true, std::memory_order_release);
+    }
+
+    /// Stop recording; recorded spans stay available for export
+    inline void stop() { detail::active.store(false, std::memory_order_release); }
+
+    /// Name the calling thread's track in exported traces
+    inline void set_thread_name(std::string name) {
+        detail::thread_slot& t = detail::local();
+        if (t.buf) {
+            std::lock_guard<std::mutex> lock(detail::registry::instance().mutex);
+            t.buf->thread_name = name;
+        }
+        t.name = std::move(name);
+    }
+
+    /// Copy a span name into storage that lives until process exit
+    /// @return Stable pointer usable as a span name
+    inline const char* intern(std::string_view name) {
+        detail::registry& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return r.names.emplace(name).first->c_str();
+    }
+
+    /// Append a finished span to the calling thread's buffer
+    /// @param name Span name; must outlive the trace (a literal or intern())
+    /// @param begin, end Times from now()
+    /// @param arg Value shown as args.n in the viewer (e.g. elements processed)
+    inline void record(const char* name, std::uint64_t begin, std::uint64_t end, std::uint64_t arg = 0) {
+        detail::local().get().push(name, begin, end, arg);
+    }
+
+    /// Records the lifetime of a scope as one span if tracing was active when it opened
+    class span {
+    public:
+        /// @param name Span name; must outlive the trace (a literal or intern())
+        /// @param arg Value shown as args.n in the viewer
+        explicit span(const char* name, std::uint64_t arg = 0) noexcept
+            : name_(active() ? name : nullptr), arg_(arg), begin_(name_ ? now() : 0) {}
+
+        ~span() {
+            if (name_) record(name_, begin_, now(), arg_);
+        }
+
+        span(const span&) = delete;
+        span& operator=(const span&) = delete;
+
+        /// Replace the recorded argument (e.g. once the amount of work is known)
+        void arg(std::uint64_t value) noexcept { arg_ = value; }
+
+    private:
+        const char* name_;
+        std::uint64_t arg_;
+        std::uint64_t begin_;
+    };
+
+    /// Write every buffered span as Chrome trace JSON (complete "X" events in microseconds)
+    /// @return Number of spans written; spans overwritten in full buffers are reported as
+    ///         otherData.dropped_spans
+    /// @note Safe to call while other threads are recording; spans they overwrite during
+    ///       the copy are skipped rather than read torn.
+    inline std::size_t write_chrome_json(std::ostream& os) {
+        struct event {
+            const char* name;
+            std::uint64_t begin, end, arg;
+        };
+        detail::registry& r = detail::registry::instance();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&] {
+            if (!first) os << ",\n";
+            first = false;
+        };
+        std::size_t written = 0;
+        std::uint64_t dropped = 0;
+        std::vector<event> events;
+        char number[96];
+        for (const auto& b : r.buffers) {
+            const std::uint64_t h1 = b->head.load(std::memory_order_acquire);
+            const std::uint64_t lo = h1 > buffer_events ? h1 - buffer_events : 0;
+            events.clear();
+            for (std::uint64_t i = lo; i < h1; ++i) {
+                const detail::slot& s = b->slots[i & (buffer_events - 1)];
+                events.push_back({s.name.load(std::memory_order_relaxed), s.begin.load(std::memory_order_relaxed),
+                                  s.end.load(std::memory_order_relaxed), s.arg.load(std::memory_order_relaxed)});
+            }
+            // Slots the owner started overwriting while we copied are unreliable
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t h2 = b->head.load(std::memory_order_relaxed);
+            const std::uint64_t valid = h2 >= buffer_events ? h2 - buffer_events + 1 : 0;
+            const std::size_t skip = static_cast<std::size_t>(std::min<std::uint64_t>(
+                events.size(), valid > lo ? valid - lo : 0));
+            dropped += lo + skip;
+
+            separator();
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":\"";
+            if (b->thread_name.empty()) os << "thread " << b->tid;
+            else detail::write_escaped(os, b->thread_name);
+            os << "\"}}";
+            for (std::size_t k = skip; k < events.size(); ++k) {
+                const event& e = events[k];
+                if (!e.name) continue;
+                separator();
+                os << "{\"name\":\"";
+                detail::write_escaped(os, e.name);
+                std::snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,",
+                              static_cast<double>(e.begin) * 1e-3,
+                              static_cast<double>(e.end >= e.begin ? e.end - e.begin : 0) * 1e-3);
+                os << number << "\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"n\":" << e.arg << "}}";
+                ++written;
+            }
+        }
+        os << "\n],\"otherData\":{\"dropped_spans\":" << dropped << "}}\n";
+        return written;
+    }
+
+    /// Write the trace to a file
+    /// @return Number of spans written
+    /// @throws std::system_error if the file cannot be written
+    inline std::size_t dump(const std::string& path) {
+        std::ofstream out(path);
+        const std::size_t written = write_chrome_json(out);
+        out.flush();
+        if (!out) throw std::system_error(std::make_error_code(std::errc::io_error), "could not write " + path);
+        return written;
+    }
+}
+
+/// Span over the rest of the enclosing scope inside a library batch entry point
+#if defined(FINCRAFTR_NO_TRACE)
+#define FINCRAFTR_TRACE_SPAN(name, arg) static_cast<void>(0)
+#else
+#define FINCRAFTR_TRACE_SPAN(name, arg) \
+    const ::fc::trace::span FINCRAFTR_TRACE_CAT(fincraftr_span_, __LINE__)(name, static_cast<std::uint64_t>(arg))
+#endif
+#define FINCRAFTR_TRACE_CAT2(a, b) a##b
+#define FINCRAFTR_TRACE_CAT(a, b) FINCRAFTR_TRACE_CAT2(a, b)
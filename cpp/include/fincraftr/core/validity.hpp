@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace fc {
+    /// Read-only view of a validity bitmap marking which elements of a column are present
+    ///
+    /// Uses the Arrow layout: bit i (least significant bit first within each byte) is set when
+    /// element i is valid. A default-constructed view has no bitmap and treats every element as
+    /// valid, so columns without missing values pay nothing.
+    struct bitmap_view {
+        const std::uint8_t* bits = nullptr; ///< Bitmap bytes, or nullptr if all elements are valid
+        std::size_t offset = 0;             ///< Bit position of element 0
+
+        /// @return True if a bitmap is attached
+        explicit operator bool() const { return bits != nullptr; }
+
+        /// @param i Element index
+        /// @return True if element i is valid
+        bool operator[](std::size_t i) const {
+            if (!bits) return true;
+            const std::size_t j = i + offset;
+            return (bits[j >> 3] >> (j & 7)) & 1u;
+        }
+    };
+}
@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+
+namespace fc::graph {
+    /// Index of a node in a ValuationGraph, assigned in insertion order
+    using node_id = std::uint32_t;
+
+    /// Dependency graph of valuations that recomputes only what a market move affects
+    ///
+    /// Input nodes hold market data (spots, rates, yields, maturities) set from outside.
+    /// Computed nodes wrap a library function (or any callable over doubles) applied to the
+    /// values of earlier nodes, e.g. a forward over spot, rate, yield and maturity, and an
+    /// option price over that forward. Because a node may only take existing nodes as
+    /// inputs, the graph is acyclic by construction and id order is a topological order.
+    ///
+    /// set() marks every transitive dependent of an input dirty without evaluating
+    /// anything. value() brings one node up to date by evaluating only its dirty ancestors;
+    /// recompute() brings all dirty nodes up to date level by level (level = longest path
+    /// from an input), running the independent nodes of each level in parallel. Work is
+    /// proportional to the nodes that depend on what changed, not to the size of the graph.
+    ///
+    /// Not thread-safe: calls on one graph must not overlap. recompute() parallelises
+    /// internally, so node functions must not call back into the graph.
+    class ValuationGraph {
+    public:
+        /// Function of a computed node, called with its input values in declaration order
+        using function = std::function<double(std::span<const double>)>;
+
+        /// Add an input node
+        /// @param value Initial value
+        /// @param name Label used in error messages and by name()
+        /// @return Id of the new node
+        node_id add_input(double value, std::string name = {}) {
+            node_id id = push(std::move(name), {}, 0);
+            nodes_[id].value = value;
+            nodes_[id].dirty = false;
+            return id;
+        }
+
+        /// Add a computed node
+        /// @param inputs Existing nodes whose values are passed to f, in order
+        /// @param f Callable taking std::span<const double> of input values
+        /// @param name Label used in error messages and by name()
+        /// @return Id of the new node; it is dirty until first evaluated
+        /// @throws std::invalid_argument if an input id does not exist or f is empty
+        node_id add_node(std::vector<node_id> inputs, function f, std::string name = {}) {
+            if (!f) throw std::invalid_argument("node function must not be empty");
+            std::uint32_t level = 0;
+            for (node_id in : inputs) {
+                check(in);
+                level = std::max(level, nodes_[in].level + 1);
+            }
+            node_id id = push(std::move(name), std::move(f), level);
+            for (node_id in : inputs) dependents_[in].push_back(id);
+            nodes_[id].inputs = std::move(inputs);
+            enqueue(id);
+            return id;
+        }
+
+        /// Add a computed node wrapping a library function of fixed arity
+        /// @param f Function such as &fc::forwards::forward_price_cont_yield<>; each input
+        ///          value is converted to the corresponding parameter type
+        /// @param inputs One existing node per parameter of f
+        /// @param name Label used in error messages and by name()
+        /// @return Id of the new node
+        /// @throws std::invalid_argument if an input id does not exist
+        template <class R, class... Args>
+        node_id add(R (*f)(Args...), std::array<node_id, sizeof...(Args)> inputs, std::string name = {}) {
+            return add_node(std::vector<node_id>(inputs.begin(), inputs.end()),
+                            [f](std::span<const double> x) {
+                                return call(f, x, std::index_sequence_for<Args...>{});
+                            },
+                            std::move(name));
+        }
+
+        /// Change an input and mark everything that depends on it dirty
+        /// @param input Input node id
+        /// @param value New value; setting the current value again marks nothing
+        /// @throws std::invalid_argument if input does not exist or is a computed node
+        void set(node_id input, double value) {
+            check(input);
+            node& n = nodes_[input];
+            if (n.f) throw std::invalid_argument("cannot set computed node " + label(input));
+            if (n.value == value) return;
+            n.value = value;
+            mark_dependents(input);
+        }
+
+        /// Current value of a node, evaluating its dirty ancestors first
+        /// @param id Node id
+        /// @return Up-to-date value
+        /// @throws std::invalid_argument if id does not exist
+        /// @throws Whatever a node function throws; that node and its dependents stay dirty
+        double value(node_id id) {
+            check(id);
+            if (!nodes_[id].dirty) return nodes_[id].value;
+            FINCRAFTR_PROBE("graph::ValuationGraph::value", 1);
+            // Collect dirty ancestors; ascending ids are a topological order
+            std::vector<node_id> order, stack{id};
+            nodes_[id].visit = true;
+            while (!stack.empty()) {
+                node_id v = stack.back();
+                stack.pop_back();
+                order.push_back(v);
+                for (node_id in : nodes_[v].inputs) {
+                    if (!nodes_[in].dirty || nodes_[in].visit) continue;
+                    nodes_[in].visit = true;
+                    stack.push_back(in);
+                }
+            }
+            std::sort(order.begin(), order.end());
+            for (node_id v : order) nodes_[v].visit = false;
+            std::vector<double> scratch;
+            for (node_id v : order) evaluate(v, scratch);
+            return nodes_[id].value;
+        }
+
+        /// Evaluate every dirty node
+        /// @param threads Worker threads for levels with many dirty nodes (0 = hardware concurrency)
+        /// @return Number of nodes evaluated
+        /// @throws Whatever a node function throws; nodes not yet evaluated stay dirty
+        std::size_t recompute(unsigned threads = 0) {
+            FINCRAFTR_PROBE("graph::ValuationGraph::recompute", pending_.size());
+            FINCRAFTR_TRACE_SPAN("graph::ValuationGraph::recompute", pending_.size());
+            // Bucket the pending nodes by level (counting sort); value() may have cleaned some
+            std::vector<std::size_t> level_begin;
+            for (node_id id : pending_) {
+                const node& n = nodes_[id];
+                if (!n.dirty) continue;
+                if (level_begin.size() < n.level + 2) level_begin.resize(n.level + 2, 0);
+                ++level_begin[n.level + 1];
+            }
+            for (std::size_t l = 1; l < level_begin.size(); ++l) level_begin[l] += level_begin[l - 1];
+            std::vector<node_id> by_level(level_begin.empty() ? 0 : level_begin.back());
+            std::vector<std::size_t> fill(level_begin);
+            for (node_id id : pending_) {
+                nodes_[id].queued = false;
+                if (nodes_[id].dirty) by_level[fill[nodes_[id].level]++] = id;
+            }
+            pending_.clear();
+
+            std::size_t evaluated = 0;
+            try {
+                for (std::size_t l = 0; l + 1 < level_begin.size(); ++l) {
+                    const std::size_t b = level_begin[l], e = level_begin[l + 1];
+                    fc::parallel::parallel_for(e - b, grain, threads, [&](std::size_t lo, std::size_t hi) {
+                        std::vector<double> scratch;
+                        for (std::size_t k = b + lo; k < b + hi; ++k) evaluate(by_level[k], scratch);
+                    });
+                    evaluated = e;
+                }
+            } catch (...) {
+                for (node_id id : by_level)
+                    if (nodes_[id].dirty) enqueue(id);
+                throw;
+            }
+            return evaluated;
+        }
+
+        /// @return True if the node's cached value is stale
+        /// @throws std::invalid_argument if id does not exist
+        bool dirty(node_id id) const {
+            check(id);
+            return nodes_[id].dirty;
+        }
+
+        /// @return Input node ids of a computed node (empty for inputs)
+        /// @throws std::invalid_argument if id does not exist
+        const std::vector<node_id>& inputs(node_id id) const {
+            check(id);
+            return nodes_[id].inputs;
+        }
+
+        /// @return Label given when the node was added
+        /// @throws std::invalid_argument if id does not exist
+        const std::string& name(node_id id) const {
+            check(id);
+            return nodes_[id].name;
+        }
+
+        /// @return Number of nodes
+        std::size_t size() const { return nodes_.size(); }
+
+        /// @return Total node evaluations since construction, for checking how much a move cost
+        std::uint64_t evaluations() const { return evaluations_; }
+
+    private:
+        /// Dirty nodes of one level handed to a single task
+        static constexpr std::size_t grain = 64;
+
+        struct node {
+            function f;                   ///< Empty for input nodes
+            std::vector<node_id> inputs;
+            std::string name;
+            double value = 0.0;
+            std::uint32_t level = 0;      ///< Longest path from an input
+            bool dirty = true;
+            bool queued = false;          ///< Listed in pending_ (value() may have cleaned it since)
+            bool visit = false;           ///< Scratch flag for traversals
+        };
+
+        template <class R, class... Args, std::size_t... I>
+        static double call(R (*f)(Args...), std::span<const double> x, std::index_sequence<I...>) {
+            return static_cast<double>(f(static_cast<Args>(x[I])...));
+        }
+
+        node_id push(std::string name, function f, std::uint32_t level) {
+            if (nodes_.size() >= std::numeric_limits<node_id>::max())
+                throw std::length_error("too many nodes in ValuationGraph");
+            node n;
+            n.f = std::move(f);
+            n.name = std::move(name);
+            n.level = level;
+            nodes_.push_back(std::move(n));
+            dependents_.emplace_back();
+            return static_cast<node_id>(nodes_.size() - 1);
+        }
+
+        void check(node_id id) const {
+            if (id >= nodes_.size()) throw std::invalid_argument("node id " + std::to_string(id) + " out of range");
+        }
+
+        std::string label(node_id id) const {
+            return nodes_[id].name.empty() ? "#" + std::to_string(id) : "'" + nodes_[id].name + "'";
+        }
+
+        void enqueue(node_id id) {
+            if (nodes_[id].queued) return;
+            nodes_[id].queued = true;
+            pending_.push_back(id);
+        }
+
+        // A dirty node's dependents are already dirty, so the walk stops there
+        void mark_dependents(node_id from) {
+            std::vector<node_id> stack(dependents_[from]);
+            while (!stack.empty()) {
+                node_id v = stack.back();
+                stack.pop_back();
+                if (nodes_[v].dirty) continue;
+                nodes_[v].dirty = true;
+                enqueue(v);
+                stack.insert(stack.end(), dependents_[v].begin(), dependents_[v].end());
+            }
+        }
+
+        // Inputs of id are up to date; different ids may be evaluated concurrently
+        void evaluate(node_id id, std::vector<double>& scratch) {
+            node& n = nodes_[id];
+            scratch.clear();
+            for (node_id in : n.inputs) scratch.push_back(nodes_[in].value);
+            n.value = n.f(std::span<const double>(scratch));
+            n.dirty = false;
+            std::atomic_ref<std::uint64_t>(evaluations_).fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::vector<node> nodes_;
+        std::vector<std::vector<node_id>> dependents_;
+        std::vector<node_id> pending_;  ///< Every dirty node, each once; recompute() drains it
+        std::uint64_t evaluations_ = 0;
+    };
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/instrument.hpp"
+#include "../core/parallel.hpp"
+#include "../core/trace.hpp"
+#include "returns.hpp"
+
+namespace fc::equity {
+    /// Columnar holdings of one portfolio against its benchmark
+    ///
+    /// Every column has one entry per security in the union of portfolio and benchmark
+    /// holdings; a security held by only one side has weight 0 on the other.
+    struct AttributionHoldings {
+        std::span<const double> portfolio_weights;   ///< Portfolio weight per security
+        std::span<const double> benchmark_weights;   ///< Benchmark weight per security
+        std::span<const double> returns;             ///< Period return per security
+        std::span<const std::uint32_t> sectors;      ///< Sector code per security, in [0, num_sectors)
+    };
+
+    /// Brinson-Fachler attribution of one portfolio's active return
+    struct BrinsonAttribution {
+        std::vector<double> allocation;  ///< (Wp_s - Wb_s) * (Rb_s - Rb) per sector
+        std::vector<double> selection;   ///< Wb_s * (Rp_s - Rb_s) per sector
+        std::vector<double> interaction; ///< (Wp_s - Wb_s) * (Rp_s - Rb_s) per sector
+        double total_allocation = 0.0;
+        double total_selection = 0.0;
+        double total_interaction = 0.0;
+        double portfolio_return = 0.0;   ///< Sum of portfolio weight * return
+        double benchmark_return = 0.0;   ///< Sum of benchmark weight * return
+    };
+
+    namespace detail {
+        /// Sums of wp, wb, wp*r and wb*r over [b, e), using independent lanes so the loop vectorizes
+        inline void attribution_segment(const double* wp, const double* wb, const double* r,
+                                        std::size_t b, std::size_t e, double* acc) {
+            constexpr std::size_t W = 4;
+            double swp[W] = {}, swb[W] = {}, swpr[W] = {}, swbr[W] = {};
+            std::size_t i = b;
+            for (; i + W <= e; i += W) {
+                for (std::size_t l = 0; l < W; ++l) {
+                    swp[l] += wp[i + l];
+                    swb[l] += wb[i + l];
+                    swpr[l] += wp[i + l] * r[i + l];
+                    swbr[l] += wb[i + l] * r[i + l];
+                }
+            }
+            for (; i < e; ++i) {
+                swp[0] += wp[i];
+                swb[0] += wb[i];
+                swpr[0] += wp[i] * r[i];
+                swbr[0] += wb[i] * r[i];
+            }
+            for (std::size_t l = 0; l < W; ++l) {
+                acc[0] += swp[l];
+                acc[1] += swb[l];
+                acc[2] += swpr[l];
+                acc[3] += swbr[l];
+            }
+        }
+    }
+
+    /// Compute simple returns for a column of prices with return_simple
+    /// @tparam Policy Error policy applied per element (fc::policy::throwing or nan)
+    /// @param Pt Current prices
+    /// @param Pt_prev Previous prices (must be nonzero)
+    /// @param out Output returns, same length as Pt
+    /// @throws std::invalid_argument if lengths differ, or a previous price is zero
+    ///         (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline void returns_simple(std::span<const double> Pt, std::span<const double> Pt_prev,
+                               std::span<double> out) {
+        FINCRAFTR_PROBE("equity::returns_simple", Pt.size());
+        if (Pt.size() != Pt_prev.size() || Pt.size() != out.size())
+            throw std::invalid_argument("price and output columns must have equal length");
+        for (std::size_t i = 0; i < Pt.size(); ++i) out[i] = return_simple<Policy>(Pt[i], Pt_prev[i]);
+    }
+
+    /// Brinson-Fachler allocation, selection and interaction effects by sector
+    /// @param h Columnar portfolio and benchmark holdings
+    /// @param num_sectors Number of sector codes
+    /// @return Per-sector and total effects; totals sum to the active return when both weight
+    ///         columns sum to 1
+    /// @throws std::invalid_argument if columns differ in length or a sector code is out of range
+    /// @note Sectors absent from one side use the other side's return as their own, so the
+    ///       effects still reconcile. Grouping holdings by sector lets each sector reduce as one
+    ///       contiguous vectorized segment.
+    inline BrinsonAttribution brinson_fachler(const AttributionHoldings& h, std::size_t num_sectors) {
+        FINCRAFTR_PROBE("equity::brinson_fachler", h.returns.size());
+        const std::size_t n = h.returns.size();
+        if (h.portfolio_weights.size() != n || h.benchmark_weights.size() != n || h.sectors.size() != n)
+            throw std::invalid_argument("attribution columns must have equal length");
+
+        // Per sector: Wp, Wb, sum wp*r, sum wb*r
+        std::vector<double> acc(4 * num_sectors, 0.0);
+        for (std::size_t b = 0; b < n;) {
+            const std::uint32_t s = h.sectors[b];
+            if (s >= num_sectors) throw std::invalid_argument("sector code out of range");
+            std::size_t e = b + 1;
+            while (e < n && h.sectors[e] == s) ++e;
+            detail::attribution_segment(h.portfolio_weights.data(), h.benchmark_weights.data(),
+                                        h.returns.data(), b, e, &acc[4 * s]);
+            b = e;
+        }
+
+        BrinsonAttribution out;
+        out.allocation.assign(num_sectors, 0.0);
+        out.selection.assign(num_sectors, 0.0);
+        out.interaction.assign(num_sectors, 0.0);
+        for (std::size_t s = 0; s < num_sectors; ++s) {
+            out.portfolio_return += acc[4 * s + 2];
+            out.benchmark_return += acc[4 * s + 3];
+        }
+        const double Rb = out.benchmark_return;
+        for (std::size_t s = 0; s < num_sectors; ++s) {
+            const double Wp = acc[4 * s], Wb = acc[4 * s + 1];
+            const double Rb_s = (Wb != 0.0) ? acc[4 * s + 3] / Wb : Rb;
+            const double Rp_s = (Wp != 0.0) ? acc[4 * s + 2] / Wp : Rb_s;
+            out.allocation[s] = (Wp - Wb) * (Rb_s - Rb);
+            out.selection[s] = Wb * (Rp_s - Rb_s);
+            out.interaction[s] = (Wp - Wb) * (Rp_s - Rb_s);
+            out.total_allocation += out.allocation[s];
+            out.total_selection += out.selection[s];
+            out.total_interaction += out.interaction[s];
+        }
+        return out;
+    }
+
+    /// Brinson-Fachler attribution for many portfolios, processed in parallel
+    /// @param portfolios Columnar holdings, one entry per portfolio
+    /// @param num_sectors Number of sector codes
+    /// @param threads Worker threads (0 = hardware concurrency)
+    /// @return One attribution per portfolio, in input order
+    /// @throws std::invalid_argument on the first malformed portfolio
+    inline std::vector<BrinsonAttribution> brinson_fachler_batch(const std::vector<AttributionHoldings>& portfolios,
+                                                                 std::size_t num_sectors,
+                                                                 unsigned threads = 0) {
+        FINCRAFTR_PROBE("equity::brinson_fachler_batch", portfolios.size());
+        FINCRAFTR_TRACE_SPAN("equity::brinson_fachler_batch", portfolios.size());
+        std::vector<BrinsonAttribution> out(portfolios.size());
+        fc::parallel::parallel_for(portfolios.size(), 16, threads,
+            [&](std::size_t b, std::size_t e) {
+                for (std::size_t p = b; p < e; ++p) out[p] = brinson_fachler(portfolios[p], num_sectors);
+            });
+        return out;
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
-#include <stdexcept>
+#include "../core/error.hpp"
+#include "../core/instrument.hpp"
 
 namespace fc::equity {
     /// Calculate the market capitalization of a company
@@ -7,17 +8,22 @@ namespace fc::equity {
     /// @param price Current price per share
     /// @return Market capitalization (shares_outstanding * price)
     inline double market_cap(double shares_outstanding, double price) {
+        FINCRAFTR_PROBE("equity::market_cap", 1);
         return shares_outstanding * price;
     }
 
     /// Calculate the ownership fraction for a given number of shares
+    /// @tparam Policy Error policy (fc::policy::throwing, nan or status)
     /// @param shares_owned Number of shares owned
     /// @param shares_outstanding Total number of shares outstanding (must be > 0)
     /// @return Ownership fraction as shares_owned / shares_outstanding
-    /// @throws std::invalid_argument if shares_outstanding <= 0
-    inline double ownership_fraction(double shares_owned, double shares_outstanding) {
-        if (shares_outstanding <= 0.0) throw std::invalid_argument("shares_outstanding must be > 0");
-        return shares_owned / shares_outstanding;
+    /// @throws std::invalid_argument if shares_outstanding <= 0 (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline typename Policy::template result_type<double>
+    ownership_fraction(double shares_owned, double shares_outstanding) {
+        FINCRAFTR_PROBE("equity::ownership_fraction", 1);
+        return Policy::check(!(shares_outstanding <= 0.0), shares_owned / shares_outstanding,
+                             "shares_outstanding must be > 0");
     }
 }
     
\ No newline at end of file
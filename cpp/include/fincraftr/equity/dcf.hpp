@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/error.hpp"
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+#include "../core/parallel.hpp"
+#include "../core/trace.hpp"
+#include "valuation.hpp"
+
+namespace fc::equity {
+    namespace detail {
+        inline std::uint64_t splitmix64(std::uint64_t x) {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        /// Lower-triangular Cholesky factor of an N x N row-major correlation matrix
+        template <std::size_t N>
+        std::array<double, N * N> cholesky(const std::array<double, N * N>& c) {
+            std::array<double, N * N> L{};
+            for (std::size_t i = 0; i < N; ++i) {
+                for (std::size_t j = 0; j <= i; ++j) {
+                    double s = c[i * N + j];
+                    for (std::size_t k = 0; k < j; ++k) s -= L[i * N + k] * L[j * N + k];
+                    if (i == j) {
+                        if (s < -1e-12) throw std::invalid_argument("correlation matrix must be positive semi-definite");
+                        L[i * N + i] = std::sqrt(std::max(s, 0.0));
+                    } else {
+                        L[i * N + j] = (L[j * N + j] > 0.0) ? s / L[j * N + j] : 0.0;
+                    }
+                }
+            }
+            return L;
+        }
+
+        /// Linearly interpolated percentiles of values[0, n); reorders values in place
+        /// @param ps Percentiles in [0, 100], sorted ascending
+        inline void percentiles_inplace(double* values, std::size_t n,
+                                        const std::vector<double>& ps, double* out) {
+            std::size_t floor_done = 0;
+            for (std::size_t k = 0; k < ps.size(); ++k) {
+                if (n == 0) { out[k] = std::numeric_limits<double>::quiet_NaN(); continue; }
+                const double h = ps[k] / 100.0 * static_cast<double>(n - 1);
+                const std::size_t lo = static_cast<std::size_t>(h);
+                std::nth_element(values + floor_done, values + lo, values + n);
+                floor_done = lo;
+                double v = values[lo];
+                if (lo + 1 < n && h > static_cast<double>(lo)) {
+                    const double next = *std::min_element(values + lo + 1, values + n);
+                    v += (h - static_cast<double>(lo)) * (next - v);
+                }
+                out[k] = v;
+            }
+        }
+    }
+
+    /// Two-stage discounted cash flow value from revenue and margin drivers
+    /// @tparam Policy Error policy (fc::policy::throwing, nan or status)
+    /// @param revenue Current revenue (base for projected cash flows)
+    /// @param margin Free cash flow margin applied to revenue
+    /// @param g Revenue growth rate during the explicit stage
+    /// @param g_terminal Perpetual growth rate after the explicit stage (must be < r)
+    /// @param r Discount rate per period
+    /// @param years Number of explicit-stage periods
+    /// @return Present value of explicit-stage cash flows plus Gordon terminal value
+    /// @throws std::invalid_argument if g_terminal >= r (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline typename Policy::template result_type<double>
+    dcf_two_stage(double revenue, double margin, double g, double g_terminal, double r, int years) {
+        FINCRAFTR_PROBE("equity::dcf_two_stage", 1);
+        const double q = (1.0 + g) / (1.0 + r);
+        const double qN = fc::math::pow(q, years);
+        const double annuity = (std::abs(1.0 - q) < 1e-12)
+            ? static_cast<double>(years)
+            : q * (1.0 - qN) / (1.0 - q);
+        // Gordon value at the horizon, discounted back: qN * (1 + g_terminal) / (r - g_terminal)
+        const double terminal = qN * ddm_gordon_growth<fc::policy::nan>(1.0 + g_terminal, r, g_terminal);
+        return Policy::check(!(g_terminal >= r), revenue * margin * (annuity + terminal),
+                             "g_terminal must be less than r");
+    }
+
+    /// Stochastic DCF drivers, used both for means and for volatilities
+    struct DcfDrivers {
+        double growth = 0.0;          ///< Explicit-stage revenue growth
+        double terminal_growth = 0.0; ///< Perpetual growth after the explicit stage
+        double margin = 0.0;          ///< Free cash flow margin
+        double discount_rate = 0.0;   ///< Discount rate
+    };
+
+    /// One company to value under the Monte Carlo DCF engine
+    struct DcfCompany {
+        double revenue = 0.0;   ///< Current revenue
+        int years = 5;          ///< Explicit-stage length in periods
+        DcfDrivers mean;        ///< Driver means
+        DcfDrivers vol;         ///< Driver standard deviations
+    };
+
+    /// Monte Carlo DCF configuration shared by all companies
+    struct DcfMonteCarloConfig {
+        std::size_t scenarios = 100000;                ///< Scenarios sampled per company
+        std::vector<double> percentiles{5.0, 50.0, 95.0}; ///< Percentiles to report, in [0, 100]
+        /// Row-major driver correlation (growth, terminal_growth, margin, discount_rate)
+        std::array<double, 16> correlation{1, 0, 0, 0,
+                                           0, 1, 0, 0,
+                                           0, 0, 1, 0,
+                                           0, 0, 0, 1};
+        std::uint64_t seed = 42;  ///< Base seed; each company derives its own stream
+        unsigned threads = 0;     ///< Worker threads (0 = hardware concurrency)
+    };
+
+    /// Fair-value distribution summary for one company
+    struct DcfDistribution {
+        std::vector<double> percentiles; ///< Values at config.percentiles (NaN if no valid scenario)
+        double mean = 0.0;               ///< Mean over valid scenarios
+        std::size_t valid = 0;           ///< Scenarios with terminal_growth < discount_rate
+        std::size_t masked = 0;          ///< Scenarios excluded as invalid
+    };
+
+    /// Monte Carlo two-stage DCF over correlated growth, margin and discount-rate drivers
+    /// @param companies Companies to value
+    /// @param config Scenario count, percentiles, driver correlation, seed and threads
+    /// @return One distribution per company, in input order
+    /// @throws std::invalid_argument if a percentile lies outside [0, 100] or the correlation
+    ///         matrix is not positive semi-definite
+    /// @note Scenarios with terminal_growth >= discount_rate are masked and counted instead of
+    ///       throwing. Results are deterministic for a given seed regardless of thread count.
+    inline std::vector<DcfDistribution> dcf_monte_carlo(const std::vector<DcfCompany>& companies,
+                                                        const DcfMonteCarloConfig& config) {
+        FINCRAFTR_PROBE("equity::dcf_monte_carlo", companies.size() * config.scenarios);
+        FINCRAFTR_TRACE_SPAN("equity::dcf_monte_carlo", companies.size() * config.scenarios);
+        for (double p : config.percentiles)
+            if (!(p >= 0.0 && p <= 100.0)) throw std::invalid_argument("percentiles must lie in [0, 100]");
+        const auto L = detail::cholesky<4>(config.correlation);
+
+        std::vector<double> ps = config.percentiles;
+        std::vector<std::size_t> order(ps.size());
+        for (std::size_t k = 0; k < order.size(); ++k) order[k] = k;
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return ps[a] < ps[b]; });
+        std::vector<double> sorted_ps(ps.size());
+        for (std::size_t k = 0; k < order.size(); ++k) sorted_ps[k] = ps[order[k]];
+
+        std::vector<DcfDistribution> out(companies.size());
+        const std::size_t S = config.scenarios;
+
+        fc::parallel::parallel_for(companies.size(), 1, config.threads,
+            [&](std::size_t begin, std::size_t end) {
+                std::vector<double> values(S);
+                std::vector<double> sorted_out(sorted_ps.size());
+                for (std::size_t c = begin; c < end; ++c) {
+                    const DcfCompany& co = companies[c];
+                    std::mt19937_64 rng(detail::splitmix64(config.seed ^ detail::splitmix64(c)));
+                    std::normal_distribution<double> normal(0.0, 1.0);
+
+                    std::size_t valid = 0;
+                    double sum = 0.0;
+                    for (std::size_t s = 0; s < S; ++s) {
+                        const double e0 = normal(rng), e1 = normal(rng), e2 = normal(rng), e3 = normal(rng);
+                        const double z0 = L[0] * e0;
+                        const double z1 = L[4] * e0 + L[5] * e1;
+                        const double z2 = L[8] * e0 + L[9] * e1 + L[10] * e2;
+                        const double z3 = L[12] * e0 + L[13] * e1 + L[14] * e2 + L[15] * e3;
+                        const double v = dcf_two_stage<fc::policy::nan>(
+                            co.revenue,
+                            co.mean.margin + co.vol.margin * z2,
+                            co.mean.growth + co.vol.growth * z0,
+                            co.mean.terminal_growth + co.vol.terminal_growth * z1,
+                            co.mean.discount_rate + co.vol.discount_rate * z3,
+                            co.years);
+                        if (!std::isnan(v)) {
+                            values[valid++] = v;
+                            sum += v;
+                        }
+                    }
+
+                    DcfDistribution& d = out[c];
+                    d.valid = valid;
+                    d.masked = S - valid;
+                    d.mean = valid ? sum / static_cast<double>(valid) : std::numeric_limits<double>::quiet_NaN();
+                    detail::percentiles_inplace(values.data(), valid, sorted_ps, sorted_out.data());
+                    d.percentiles.assign(ps.size(), 0.0);
+                    for (std::size_t k = 0; k < order.size(); ++k) d.percentiles[order[k]] = sorted_out[k];
+                }
+            });
+        return out;
+    }
+}
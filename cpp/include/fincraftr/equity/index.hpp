@@ -1,15 +1,74 @@
 #pragma once
+#include <cmath>
+#include <cstddef>
 #include <numeric>
+#include <span>
+#include <stdexcept>
 #include <vector>
-#include <cmath>
+
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+#include "../core/validity.hpp"
 
 namespace fc::equity {
+    /// Calculate price-weighted index value over a column of prices
+    /// @param prices Current stock prices
+    /// @param D Divisor used for index calculation
+    /// @param valid Validity bitmap; missing prices are left out of the sum
+    /// @return Price-weighted index value
+    inline double index_price_weighted(std::span<const double> prices, double D,
+                                       fc::bitmap_view valid = {}) {
+        FINCRAFTR_PROBE("equity::index_price_weighted", prices.size());
+        double sum = 0.0;
+        if (!valid) {
+            sum = std::accumulate(prices.begin(), prices.end(), 0.0);
+        } else {
+            for (std::size_t i = 0; i < prices.size(); ++i)
+                if (valid[i]) sum += prices[i];
+        }
+        return sum / D;
+    }
+
     /// Calculate price-weighted index value
     /// @param prices Vector of current stock prices
     /// @param D Divisor used for index calculation
     /// @return Price-weighted index value
     inline double index_price_weighted(const std::vector<double>& prices, double D) {
-        return std::accumulate(prices.begin(), prices.end(), 0.0) / D;
+        return index_price_weighted(std::span<const double>(prices), D);
+    }
+
+    /// Calculate capitalization-weighted index value over columns of market caps
+    /// @param prev_index Previous index value
+    /// @param caps_now Current market capitalizations
+    /// @param caps_prev Previous market capitalizations; without bitmaps the two columns are
+    ///        summed independently and may differ in length (added or dropped constituents)
+    /// @param J Adjustment factor for corporate actions (default 0.0)
+    /// @param valid_now Validity bitmap of caps_now
+    /// @param valid_prev Validity bitmap of caps_prev
+    /// @return New capitalization-weighted index value; with bitmaps, constituents missing on
+    ///         either side are left out of both sums
+    /// @throws std::invalid_argument if a bitmap is given and the columns differ in length
+    inline double index_cap_weighted(double prev_index,
+                                     std::span<const double> caps_now,
+                                     std::span<const double> caps_prev,
+                                     double J = 0.0,
+                                     fc::bitmap_view valid_now = {},
+                                     fc::bitmap_view valid_prev = {}) {
+        FINCRAFTR_PROBE("equity::index_cap_weighted", caps_now.size());
+        double sum_now = 0.0, sum_prev = 0.0;
+        if (!valid_now && !valid_prev) {
+            sum_now = std::accumulate(caps_now.begin(), caps_now.end(), 0.0);
+            sum_prev = std::accumulate(caps_prev.begin(), caps_prev.end(), 0.0);
+        } else {
+            if (caps_now.size() != caps_prev.size())
+                throw std::invalid_argument("caps_now and caps_prev must have equal length when masked");
+            for (std::size_t i = 0; i < caps_now.size(); ++i) {
+                if (!valid_now[i] || !valid_prev[i]) continue;
+                sum_now += caps_now[i];
+                sum_prev += caps_prev[i];
+            }
+        }
+        return prev_index * (sum_now / (sum_prev + J));
     }
 
     /// Calculate capitalization-weighted index value
@@ -22,9 +81,35 @@ namespace fc::equity {
                                      const std::vector<double>& caps_now,
                                      const std::vector<double>& caps_prev,
                                      double J=0.0) {
-        double sum_now = std::accumulate(caps_now.begin(), caps_now.end(), 0.0);
-        double sum_prev = std::accumulate(caps_prev.begin(), caps_prev.end(), 0.0);
-        return prev_index * (sum_now / (sum_prev + J));
+        return index_cap_weighted(prev_index, std::span<const double>(caps_now),
+                                  std::span<const double>(caps_prev), J);
+    }
+
+    /// Calculate Value Line geometric index over columns of prices
+    /// @param prev_index Previous index value
+    /// @param prices_now Current stock prices
+    /// @param prices_prev Previous stock prices (same length as prices_now)
+    /// @param valid_now Validity bitmap of prices_now
+    /// @param valid_prev Validity bitmap of prices_prev
+    /// @return New Value Line geometric index value; constituents missing on either side are
+    ///         left out of the geometric mean
+    /// @throws std::invalid_argument if the columns differ in length
+    inline double index_value_line_geo(double prev_index,
+                                       std::span<const double> prices_now,
+                                       std::span<const double> prices_prev,
+                                       fc::bitmap_view valid_now = {},
+                                       fc::bitmap_view valid_prev = {}) {
+        FINCRAFTR_PROBE("equity::index_value_line_geo", prices_now.size());
+        if (prices_now.size() != prices_prev.size())
+            throw std::invalid_argument("prices_now and prices_prev must have equal length");
+        double product = 1.0;
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < prices_now.size(); ++i) {
+            if (!valid_now[i] || !valid_prev[i]) continue;
+            product *= prices_now[i] / prices_prev[i];
+            ++n;
+        }
+        return prev_index * fc::math::pow(product, 1.0 / n);
     }
 
     /// Calculate Value Line geometric index
@@ -32,13 +117,39 @@ namespace fc::equity {
     /// @param prices_now Vector of current stock prices
     /// @param prices_prev Vector of previous stock prices
     /// @return New Value Line geometric index value
+    /// @throws std::invalid_argument if the vectors differ in length
     inline double index_value_line_geo(double prev_index,
                                        const std::vector<double>& prices_now,
                                        const std::vector<double>& prices_prev) {
-        double product = 1.0;
-        for (size_t i = 0; i < prices_now.size(); ++i)
-            product *= prices_now[i] / prices_prev[i];
-        return prev_index * std::pow(product, 1.0 / prices_now.size());
+        return index_value_line_geo(prev_index, std::span<const double>(prices_now),
+                                    std::span<const double>(prices_prev));
+    }
+
+    /// Calculate Value Line arithmetic index over columns of prices
+    /// @param prev_index Previous index value
+    /// @param prices_now Current stock prices
+    /// @param prices_prev Previous stock prices (same length as prices_now)
+    /// @param valid_now Validity bitmap of prices_now
+    /// @param valid_prev Validity bitmap of prices_prev
+    /// @return New Value Line arithmetic index value; constituents missing on either side are
+    ///         left out of the average
+    /// @throws std::invalid_argument if the columns differ in length
+    inline double index_value_line_arith(double prev_index,
+                                         std::span<const double> prices_now,
+                                         std::span<const double> prices_prev,
+                                         fc::bitmap_view valid_now = {},
+                                         fc::bitmap_view valid_prev = {}) {
+        FINCRAFTR_PROBE("equity::index_value_line_arith", prices_now.size());
+        if (prices_now.size() != prices_prev.size())
+            throw std::invalid_argument("prices_now and prices_prev must have equal length");
+        double sum = 0.0;
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < prices_now.size(); ++i) {
+            if (!valid_now[i] || !valid_prev[i]) continue;
+            sum += prices_now[i] / prices_prev[i];
+            ++n;
+        }
+        return prev_index * (sum / n);
     }
 
     /// Calculate Value Line arithmetic index
@@ -46,13 +157,11 @@ namespace fc::equity {
     /// @param prices_now Vector of current stock prices
     /// @param prices_prev Vector of previous stock prices
     /// @return New Value Line arithmetic index value
+    /// @throws std::invalid_argument if the vectors differ in length
     inline double index_value_line_arith(double prev_index,
                                          const std::vector<double>& prices_now,
                                          const std::vector<double>& prices_prev) {
-        std::vector<double> ratios(prices_now.size());
-        for (size_t i=0; i<prices_now.size(); ++i)
-            ratios[i] = prices_now[i] / prices_prev[i];
-        double avg = std::accumulate(ratios.begin(), ratios.end(), 0.0) / ratios.size();
-        return prev_index * avg;
+        return index_value_line_arith(prev_index, std::span<const double>(prices_now),
+                                      std::span<const double>(prices_prev));
     }
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/instrument.hpp"
+#include "../core/parallel.hpp"
+#include "../core/trace.hpp"
+#include "basic.hpp"
+
+namespace fc::equity {
+    /// A direct shareholding of one entity in another
+    struct Shareholding {
+        std::uint32_t holder = 0;        ///< Entity holding the shares
+        std::uint32_t investee = 0;      ///< Entity whose shares are held
+        double shares_owned = 0.0;       ///< Number of investee shares held
+        double shares_outstanding = 0.0; ///< Investee shares outstanding (must be > 0)
+    };
+
+    /// Convergence controls for look-through ownership
+    struct LookThroughOptions {
+        double tolerance = 1e-12;         ///< Stop once the largest update falls below this
+        double prune = 1e-15;             ///< Indirect contributions below this are dropped
+        std::size_t max_iterations = 1000; ///< Upper bound on chain length explored
+        unsigned threads = 0;             ///< Worker threads (0 = hardware concurrency)
+    };
+
+    /// Look-through ownership of every entity in one target
+    struct LookThroughResult {
+        std::vector<double> ownership; ///< ownership[i] = direct plus indirect stake of entity i
+        std::size_t iterations = 0;    ///< Chain-length iterations performed
+        bool converged = false;        ///< True if the update fell below tolerance
+    };
+
+    /// Sparse shareholding graph with look-through (direct plus indirect) ownership queries
+    ///
+    /// The stake matrix A holds A[i][j] = ownership_fraction of entity i in entity j. Total
+    /// ownership in a target t is x = (I - A)^{-1} a_t with a_t the t-th column of A, computed
+    /// as the Neumann series a_t + A a_t + A^2 a_t + ... one chain length at a time. While the
+    /// set of entities reached is small the update is pushed along investee -> holder edges;
+    /// once it grows past a fraction of the graph a row-parallel sparse matrix-vector product
+    /// takes over.
+    class OwnershipGraph {
+    public:
+        /// Build the stake matrix
+        /// @param num_entities Number of entity ids
+        /// @param holdings Direct shareholdings (duplicates are summed)
+        /// @throws std::invalid_argument if an id is out of range, shares_outstanding <= 0,
+        ///         or the stakes held in one investee sum to more than 1
+        OwnershipGraph(std::size_t num_entities, const std::vector<Shareholding>& holdings)
+            : n_(num_entities) {
+            std::vector<double> held(n_, 0.0);
+            for (const Shareholding& h : holdings) {
+                if (h.holder >= n_ || h.investee >= n_) throw std::invalid_argument("entity id out of range");
+                held[h.investee] += ownership_fraction(h.shares_owned, h.shares_outstanding);
+            }
+            for (double s : held)
+                if (s > 1.0 + 1e-9) throw std::invalid_argument("stakes held in an investee must sum to at most 1");
+
+            build(holdings, row_ptr_, col_, val_, true);
+            build(holdings, holders_ptr_, holders_, holders_val_, false);
+        }
+
+        /// @return Number of entities in the graph
+        std::size_t size() const { return n_; }
+
+        /// @return Number of stored direct stakes
+        std::size_t edges() const { return col_.size(); }
+
+        /// @param holder Holding entity
+        /// @param investee Held entity
+        /// @return Direct stake of holder in investee (0 if none)
+        double direct_stake(std::uint32_t holder, std::uint32_t investee) const {
+            double s = 0.0;
+            for (std::size_t k = row_ptr_.at(holder); k < row_ptr_[holder + 1]; ++k)
+                if (col_[k] == investee) s += val_[k];
+            return s;
+        }
+
+        /// Direct plus indirect ownership of every entity in target
+        /// @param target Entity whose ownership is traced
+        /// @param options Tolerance, pruning, iteration cap and threads
+        /// @return Ownership vector with iteration count and convergence flag
+        /// @throws std::invalid_argument if target is out of range
+        LookThroughResult look_through(std::uint32_t target, const LookThroughOptions& options = {}) const {
+            FINCRAFTR_PROBE("equity::OwnershipGraph::look_through", n_);
+            FINCRAFTR_TRACE_SPAN("equity::OwnershipGraph::look_through", n_);
+            if (target >= n_) throw std::invalid_argument("target id out of range");
+            LookThroughResult res;
+            res.ownership.assign(n_, 0.0);
+            std::vector<double> delta(n_, 0.0), next(n_, 0.0);
+            std::vector<std::uint32_t> frontier, next_frontier;
+            std::vector<char> in_next(n_, 0);
+
+            for (std::size_t k = holders_ptr_[target]; k < holders_ptr_[target + 1]; ++k) {
+                const std::uint32_t i = holders_[k];
+                if (!in_next[i]) { in_next[i] = 1; frontier.push_back(i); }
+                delta[i] += holders_val_[k];
+            }
+            for (std::uint32_t i : frontier) in_next[i] = 0;
+            bool dense = false;
+            const std::size_t dense_threshold = std::max<std::size_t>(n_ / 32, 1024);
+
+            while (res.iterations < options.max_iterations) {
+                ++res.iterations;
+                double largest = 0.0;
+                if (!dense) {
+                    for (std::uint32_t j : frontier) {
+                        res.ownership[j] += delta[j];
+                        largest = std::max(largest, std::abs(delta[j]));
+                    }
+                    if (largest < options.tolerance) { res.converged = true; break; }
+                    // Push: delta_next[i] += A[i][j] * delta[j] over holders i of each reached j
+                    next_frontier.clear();
+                    for (std::uint32_t j : frontier) {
+                        const double dj = delta[j];
+                        for (std::size_t k = holders_ptr_[j]; k < holders_ptr_[j + 1]; ++k) {
+                            const std::uint32_t i = holders_[k];
+                            if (!in_next[i]) { in_next[i] = 1; next_frontier.push_back(i); }
+                            next[i] += holders_val_[k] * dj;
+                        }
+                    }
+                    for (std::uint32_t j : frontier) delta[j] = 0.0;
+                    frontier.clear();
+                    for (std::uint32_t i : next_frontier) {
+                        in_next[i] = 0;
+                        if (std::abs(next[i]) >= options.prune) {
+                            delta[i] = next[i];
+                            frontier.push_back(i);
+                        }
+                        next[i] = 0.0;
+                    }
+                    if (frontier.empty()) { res.converged = true; break; }
+                    dense = frontier.size() > dense_threshold;
+                } else {
+                    for (std::size_t i = 0; i < n_; ++i) {
+                        res.ownership[i] += delta[i];
+                        largest = std::max(largest, std::abs(delta[i]));
+                    }
+                    if (largest < options.tolerance) { res.converged = true; break; }
+                    // Pull: delta_next = A * delta, rows split across threads
+                    fc::parallel::parallel_for(n_, 16384, options.threads,
+                        [&](std::size_t b, std::size_t e) {
+                            for (std::size_t i = b; i < e; ++i) {
+                                double s = 0.0;
+                                for (std::size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k)
+                                    s += val_[k] * delta[col_[k]];
+                                next[i] = (std::abs(s) >= options.prune) ? s : 0.0;
+                            }
+                        });
+                    delta.swap(next);
+                }
+            }
+            return res;
+        }
+
+        /// Look-through ownership for several targets, processed in parallel
+        /// @param targets Entities whose ownership is traced
+        /// @param options Tolerance, pruning, iteration cap and threads
+        /// @return One result per target, in input order
+        /// @throws std::invalid_argument if a target is out of range
+        std::vector<LookThroughResult> look_through(const std::vector<std::uint32_t>& targets,
+                                                    const LookThroughOptions& options = {}) const {
+            std::vector<LookThroughResult> out(targets.size());
+            LookThroughOptions single = options;
+            single.threads = 1;
+            fc::parallel::parallel_for(targets.size(), 1, options.threads,
+                [&](std::size_t b, std::size_t e) {
+                    for (std::size_t t = b; t < e; ++t) out[t] = look_through(targets[t], single);
+                });
+            return out;
+        }
+
+    private:
+        // Compressed sparse rows keyed by holder (by_holder) or by investee
+        void build(const std::vector<Shareholding>& holdings, std::vector<std::size_t>& ptr,
+                   std::vector<std::uint32_t>& idx, std::vector<double>& val, bool by_holder) const {
+            ptr.assign(n_ + 1, 0);
+            for (const Shareholding& h : holdings) ++ptr[(by_holder ? h.holder : h.investee) + 1];
+            for (std::size_t i = 0; i < n_; ++i) ptr[i + 1] += ptr[i];
+            idx.resize(holdings.size());
+            val.resize(holdings.size());
+            std::vector<std::size_t> fill(ptr.begin(), ptr.end() - 1);
+            for (const Shareholding& h : holdings) {
+                const std::size_t k = fill[by_holder ? h.holder : h.investee]++;
+                idx[k] = by_holder ? h.investee : h.holder;
+                val[k] = ownership_fraction(h.shares_owned, h.shares_outstanding);
+            }
+        }
+
+        std::size_t n_;
+        std::vector<std::size_t> row_ptr_;      // holder -> investees
+        std::vector<std::uint32_t> col_;
+        std::vector<double> val_;
+        std::vector<std::size_t> holders_ptr_;  // investee -> holders
+        std::vector<std::uint32_t> holders_;
+        std::vector<double> holders_val_;
+    };
+}
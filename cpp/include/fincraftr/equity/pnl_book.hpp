@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+#include "../core/trace.hpp"
+#include "profit.hpp"
+
+namespace fc::equity {
+    /// One position lot, valued with profit_with_costs at the instrument's latest price
+    struct PnlLot {
+        std::uint32_t instrument = 0; ///< Instrument id in [0, num_instruments)
+        std::uint32_t desk = 0;       ///< Desk id in [0, num_desks)
+        double quantity = 0.0;        ///< Signed number of units held
+        double S0 = 0.0;              ///< Entry price (used as the mark until the first tick)
+        double r = 0.0;               ///< Financing rate (continuous)
+        double tau = 0.0;             ///< Holding period
+        double D_tau = 0.0;           ///< Dividends received during holding period
+        double C0 = 0.0;              ///< Initial costs financed at r over tau
+    };
+
+    /// Position book that keeps lot, instrument, desk and firm P&L up to date tick by tick
+    ///
+    /// Lots are stored structure-of-arrays, sorted by instrument and then desk, so a tick
+    /// touches one contiguous slice. Per-lot P&L is quantity * profit_with_costs(...), which
+    /// is affine in the price: quantity * ST + carry, with the exp(r * tau) financing folded
+    /// into carry once at construction. Desk and firm totals are moved by the slice delta
+    /// instead of being re-summed.
+    class PnlBook {
+    public:
+        /// Build a book from lots
+        /// @param lots Position lots (any order)
+        /// @param num_instruments Number of instrument ids
+        /// @param num_desks Number of desk ids
+        /// @throws std::invalid_argument if a lot's instrument or desk id is out of range
+        PnlBook(const std::vector<PnlLot>& lots, std::size_t num_instruments, std::size_t num_desks)
+            : instrument_begin_(num_instruments + 1, 0),
+              instrument_run_begin_(num_instruments + 1, 0),
+              instrument_pnl_(num_instruments, 0.0),
+              desk_pnl_(num_desks, 0.0) {
+            for (const PnlLot& lot : lots) {
+                if (lot.instrument >= num_instruments) throw std::invalid_argument("lot instrument id out of range");
+                if (lot.desk >= num_desks) throw std::invalid_argument("lot desk id out of range");
+            }
+
+            std::vector<std::size_t> order(lots.size());
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                if (lots[a].instrument != lots[b].instrument) return lots[a].instrument < lots[b].instrument;
+                return lots[a].desk < lots[b].desk;
+            });
+
+            const std::size_t n = lots.size();
+            quantity_.resize(n);
+            financing_.resize(n);
+            carry_.resize(n);
+            pnl_.resize(n);
+            position_.resize(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                const PnlLot& lot = lots[order[k]];
+                position_[order[k]] = k;
+                quantity_[k] = lot.quantity;
+                financing_[k] = fc::math::exp(lot.r * lot.tau);
+                carry_[k] = lot.quantity * (lot.D_tau - lot.C0 * financing_[k]);
+                pnl_[k] = lot.quantity * profit_with_costs(lot.S0, lot.S0, lot.r, lot.tau, lot.D_tau, lot.C0);
+                ++instrument_begin_[lot.instrument + 1];
+            }
+            for (std::size_t i = 0; i < num_instruments; ++i)
+                instrument_begin_[i + 1] += instrument_begin_[i];
+
+            for (std::size_t i = 0; i < num_instruments; ++i) {
+                instrument_run_begin_[i] = run_begin_.size();
+                for (std::size_t k = instrument_begin_[i]; k < instrument_begin_[i + 1]; ++k) {
+                    const std::uint32_t desk = lots[order[k]].desk;
+                    if (k == instrument_begin_[i] || run_desk_.back() != desk) {
+                        run_begin_.push_back(k);
+                        run_desk_.push_back(desk);
+                    }
+                }
+            }
+            instrument_run_begin_[num_instruments] = run_begin_.size();
+            run_begin_.push_back(n);
+            run_pnl_.assign(run_desk_.size(), 0.0);
+            resync();
+        }
+
+        /// Apply a price tick to one instrument and propagate the change upward
+        /// @param instrument Instrument id
+        /// @param price New price of the instrument
+        /// @return Change in firm P&L caused by this tick
+        /// @throws std::invalid_argument if instrument is out of range
+        double on_tick(std::uint32_t instrument, double price) {
+            FINCRAFTR_PROBE("equity::PnlBook::on_tick", 1);
+            if (instrument >= instrument_pnl_.size()) throw std::invalid_argument("instrument id out of range");
+            double instrument_delta = 0.0;
+            for (std::size_t run = instrument_run_begin_[instrument]; run < instrument_run_begin_[instrument + 1]; ++run) {
+                const std::size_t b = run_begin_[run], e = run_begin_[run + 1];
+                double sum = 0.0;
+                for (std::size_t k = b; k < e; ++k) {
+                    const double v = quantity_[k] * price + carry_[k];
+                    pnl_[k] = v;
+                    sum += v;
+                }
+                const double delta = sum - run_pnl_[run];
+                run_pnl_[run] = sum;
+                desk_pnl_[run_desk_[run]] += delta;
+                instrument_delta += delta;
+            }
+            instrument_pnl_[instrument] += instrument_delta;
+            firm_pnl_ += instrument_delta;
+            return instrument_delta;
+        }
+
+        /// Recompute every aggregate from the lot P&L to discard accumulated rounding drift
+        void resync() {
+            FINCRAFTR_PROBE("equity::PnlBook::resync", pnl_.size());
+            FINCRAFTR_TRACE_SPAN("equity::PnlBook::resync", pnl_.size());
+            std::fill(instrument_pnl_.begin(), instrument_pnl_.end(), 0.0);
+            std::fill(desk_pnl_.begin(), desk_pnl_.end(), 0.0);
+            firm_pnl_ = 0.0;
+            for (std::size_t i = 0; i < instrument_pnl_.size(); ++i) {
+                for (std::size_t run = instrument_run_begin_[i]; run < instrument_run_begin_[i + 1]; ++run) {
+                    double sum = 0.0;
+                    for (std::size_t k = run_begin_[run]; k < run_begin_[run + 1]; ++k) sum += pnl_[k];
+                    run_pnl_[run] = sum;
+                    desk_pnl_[run_desk_[run]] += sum;
+                    instrument_pnl_[i] += sum;
+                }
+                firm_pnl_ += instrument_pnl_[i];
+            }
+        }
+
+        /// @return Total P&L across all lots
+        double firm_pnl() const { return firm_pnl_; }
+
+        /// @param desk Desk id
+        /// @return Total P&L of the desk's lots
+        double desk_pnl(std::uint32_t desk) const { return desk_pnl_.at(desk); }
+
+        /// @param instrument Instrument id
+        /// @return Total P&L of the instrument's lots
+        double instrument_pnl(std::uint32_t instrument) const { return instrument_pnl_.at(instrument); }
+
+        /// @param lot Index of the lot in the vector passed to the constructor
+        /// @return Current P&L of that lot
+        double lot_pnl(std::size_t lot) const { return pnl_[position_.at(lot)]; }
+
+        /// @param lot Index of the lot in the vector passed to the constructor
+        /// @return Precomputed financing factor exp(r * tau) of that lot
+        double financing_factor(std::size_t lot) const { return financing_[position_.at(lot)]; }
+
+        /// @return Number of lots in the book
+        std::size_t size() const { return pnl_.size(); }
+
+    private:
+        // Lot columns, sorted by (instrument, desk)
+        std::vector<double> quantity_;
+        std::vector<double> financing_;
+        std::vector<double> carry_;
+        std::vector<double> pnl_;
+        std::vector<std::size_t> position_;          // input index -> sorted index
+
+        // Slices: instrument i owns lots [instrument_begin_[i], instrument_begin_[i+1]) and
+        // desk runs [instrument_run_begin_[i], instrument_run_begin_[i+1])
+        std::vector<std::size_t> instrument_begin_;
+        std::vector<std::size_t> instrument_run_begin_;
+        std::vector<std::size_t> run_begin_;
+        std::vector<std::uint32_t> run_desk_;
+        std::vector<double> run_pnl_;
+
+        std::vector<double> instrument_pnl_;
+        std::vector<double> desk_pnl_;
+        double firm_pnl_ = 0.0;
+    };
+}
@@ -1,18 +1,25 @@
 #pragma once
 #include <cmath>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::equity {
     /// Calculate simple profit from holding a stock position
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S0 Initial stock price
     /// @param ST Final stock price
     /// @param r Risk-free rate (continuous)
     /// @param tau Holding period
     /// @return Profit after accounting for opportunity cost
+    template <class Math = fc::math::exact>
     inline double profit_simple(double S0, double ST, double r, double tau) {
-        return ST - S0 * std::exp(r * tau);
+        FINCRAFTR_PROBE("equity::profit_simple", 1);
+        return ST - S0 * fc::math::exp<Math>(r * tau);
     }
 
     /// Calculate profit from holding a stock position with transaction costs and dividends
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S0 Initial stock price
     /// @param ST Final stock price
     /// @param r Risk-free rate (continuous)
@@ -20,8 +27,10 @@ namespace fc::equity {
     /// @param D_tau Dividends received during holding period
     /// @param C0 Initial transaction costs
     /// @return Total profit including dividends and costs
+    template <class Math = fc::math::exact>
     inline double profit_with_costs(double S0, double ST, double r, double tau,
         double D_tau, double C0) {
-        return ST + D_tau - C0 * std::exp(r * tau);
+        FINCRAFTR_PROBE("equity::profit_with_costs", 1);
+        return ST + D_tau - C0 * fc::math::exp<Math>(r * tau);
     }
 }
\ No newline at end of file
@@ -1,14 +1,18 @@
 #pragma once
-#include <stdexcept>
+#include "../core/error.hpp"
+#include "../core/instrument.hpp"
 
 namespace fc::equity {
     /// How much did this stock gain/lose relative to its previous price?
+    /// @tparam Policy Error policy (fc::policy::throwing, nan or status)
     /// @param Pt Current price
     /// @param Pt_prev Previous price (must be nonzero)
     /// @return Simple return as (Pt / Pt_prev) - 1.0
-    /// @throws std::invalid_argument if Pt_prev is zero
-    inline double return_simple(double Pt, double Pt_prev) {
-        if (Pt_prev == 0.0) throw std::invalid_argument("Previous price must be nonzero");
-        return (Pt / Pt_prev) - 1.0;
+    /// @throws std::invalid_argument if Pt_prev is zero (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline typename Policy::template result_type<double>
+    return_simple(double Pt, double Pt_prev) {
+        FINCRAFTR_PROBE("equity::return_simple", 1);
+        return Policy::check(Pt_prev != 0.0, (Pt / Pt_prev) - 1.0, "Previous price must be nonzero");
     }
 }
\ No newline at end of file
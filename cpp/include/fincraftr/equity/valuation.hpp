@@ -1,9 +1,14 @@
 #pragma once
 
-#include <stdexcept>
+#include <span>
 #include <vector>
 #include <cmath>
 
+#include "../core/error.hpp"
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+#include "../core/validity.hpp"
+
 namespace fc::equity {
     /// Single-period dividend discount model
     /// @param D1 Expected dividend at end of period
@@ -11,9 +16,26 @@ namespace fc::equity {
     /// @param r Required rate of return
     /// @return Present value of stock
     inline double ddm_single_period(double D1, double S1, double r) {
+        FINCRAFTR_PROBE("equity::ddm_single_period", 1);
         return (D1 + S1) / (1.0 + r);
     }
 
+    /// Multi-period dividend discount model with terminal value over a column of dividends
+    /// @param dividends Expected dividends for each period
+    /// @param ST Terminal stock price after dividend periods
+    /// @param r Required rate of return
+    /// @param valid Validity bitmap; missing dividends contribute nothing but keep their period
+    /// @return Present value of stock
+    inline double ddm_multi_period(std::span<const double> dividends, double ST, double r,
+                                   fc::bitmap_view valid = {}) {
+        FINCRAFTR_PROBE("equity::ddm_multi_period", dividends.size());
+        double pv = 0.0;
+        for (size_t t=0; t<dividends.size(); ++t)
+            if (valid[t]) pv += dividends[t] / fc::math::pow(1.0 + r, static_cast<double>(t+1));
+        pv += ST / fc::math::pow(1.0 + r, static_cast<double>(dividends.size()));
+        return pv;
+    }
+
     /// Multi-period dividend discount model with terminal value
     /// @param dividends Vector of expected dividends for each period
     /// @param ST Terminal stock price after dividend periods
@@ -21,10 +43,20 @@ namespace fc::equity {
     /// @return Present value of stock
     inline double ddm_multi_period(const std::vector<double>& dividends,
         double ST, double r) {
+        return ddm_multi_period(std::span<const double>(dividends), ST, r);
+    }
+
+    /// Infinite-period dividend discount model (perpetuity) over a column of dividends
+    /// @param dividends Expected dividends for each period
+    /// @param r Required rate of return
+    /// @param valid Validity bitmap; missing dividends contribute nothing but keep their period
+    /// @return Present value assuming dividends continue indefinitely
+    inline double ddm_infinite(std::span<const double> dividends, double r,
+                               fc::bitmap_view valid = {}) {
+        FINCRAFTR_PROBE("equity::ddm_infinite", dividends.size());
         double pv = 0.0;
         for (size_t t=0; t<dividends.size(); ++t)
-            pv += dividends[t] / std::pow(1.0 + r, static_cast<int>(t+1));
-        pv += ST / std::pow(1.0 + r, dividends.size());
+            if (valid[t]) pv += dividends[t] / fc::math::pow(1.0 + r, static_cast<double>(t+1));
         return pv;
     }
 
@@ -33,31 +65,34 @@ namespace fc::equity {
     /// @param r Required rate of return
     /// @return Present value assuming dividends continue indefinitely
     inline double ddm_infinite(const std::vector<double>& dividends, double r) {
-        double pv = 0.0;
-        for (size_t t=0; t<dividends.size(); ++t)
-            pv += dividends[t] / std::pow(1.0 + r, static_cast<int>(t+1));
-        return pv;
+        return ddm_infinite(std::span<const double>(dividends), r);
     }
 
     /// Calculate cost of equity using dividend growth model
+    /// @tparam Policy Error policy (fc::policy::throwing, nan or status)
     /// @param D1 Expected dividend at end of period
     /// @param S1 Expected stock price at end of period
     /// @param S0 Current stock price (must be nonzero)
     /// @return Cost of equity as required rate of return
-    /// @throws std::invalid_argument if S0 is zero
-    inline double cost_of_equity(double D1, double S1, double S0) {
-        if (S0 == 0.0) throw std::invalid_argument("S0 must be nonzero");
-        return (D1 + S1) / S0 - 1.0;
+    /// @throws std::invalid_argument if S0 is zero (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline typename Policy::template result_type<double>
+    cost_of_equity(double D1, double S1, double S0) {
+        FINCRAFTR_PROBE("equity::cost_of_equity", 1);
+        return Policy::check(S0 != 0.0, (D1 + S1) / S0 - 1.0, "S0 must be nonzero");
     }
 
     /// Gordon growth model for dividend discount valuation
+    /// @tparam Policy Error policy (fc::policy::throwing, nan or status)
     /// @param D1 Expected dividend next period
     /// @param r Required rate of return
     /// @param g Constant growth rate of dividends (must be < r)
     /// @return Present value of stock with constant dividend growth
-    /// @throws std::invalid_argument if g >= r
-    inline double ddm_gordon_growth(double D1, double r, double g) {
-        if (g >= r) throw std::invalid_argument("g must be less than r");
-        return D1 / (r - g);
+    /// @throws std::invalid_argument if g >= r (policy::throwing)
+    template <class Policy = fc::policy::throwing>
+    inline typename Policy::template result_type<double>
+    ddm_gordon_growth(double D1, double r, double g) {
+        FINCRAFTR_PROBE("equity::ddm_gordon_growth", 1);
+        return Policy::check(!(g >= r), D1 / (r - g), "g must be less than r");
     }
 }
\ No newline at end of file
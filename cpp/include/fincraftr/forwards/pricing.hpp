@@ -2,33 +2,45 @@
 
 #include <cmath>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::forwards {
     /// Calculate forward price for an asset with no dividends
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S Current spot price of the underlying asset
     /// @param r Risk-free interest rate (continuous)
     /// @param tau Time to expiration
     /// @return Forward price assuming no dividends
+    template <class Math = fc::math::exact>
     inline double forward_price_no_div(double S, double r, double tau) {
-        return S * std::exp(r * tau);
+        FINCRAFTR_PROBE("forwards::forward_price_no_div", 1);
+        return S * fc::math::exp<Math>(r * tau);
     }
     
     /// Calculate forward price for an asset with known discrete dividend
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S Current spot price of the underlying asset
     /// @param D Present value of known dividends during contract life
     /// @param r Risk-free interest rate (continuous)
     /// @param tau Time to expiration
     /// @return Forward price accounting for discrete dividends
+    template <class Math = fc::math::exact>
     inline double forward_price_with_div(double S, double D, double r, double tau) {
-        return (S - D) * std::exp(r * tau);
+        FINCRAFTR_PROBE("forwards::forward_price_with_div", 1);
+        return (S - D) * fc::math::exp<Math>(r * tau);
     }
     
     /// Calculate forward price for an asset with continuous dividend yield
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S Current spot price of the underlying asset
     /// @param r Risk-free interest rate (continuous)
     /// @param q Continuous dividend yield
     /// @param tau Time to expiration
     /// @return Forward price accounting for continuous dividend yield
+    template <class Math = fc::math::exact>
     inline double forward_price_cont_yield(double S, double r, double q, double tau) {
-        return S * std::exp((r - q) * tau);
+        FINCRAFTR_PROBE("forwards::forward_price_cont_yield", 1);
+        return S * fc::math::exp<Math>((r - q) * tau);
     }
 }
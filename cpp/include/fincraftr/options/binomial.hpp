@@ -2,6 +2,9 @@
 #include <cmath>
 #include <utility>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::options {
     /// Calculate call option payoffs in up and down states for binomial model
     /// @param Su Stock price in up state
@@ -9,6 +12,7 @@ namespace fc::options {
     /// @param K Strike price
     /// @return Pair of (payoff_up, payoff_down)
     inline std::pair<double,double> payoff_binomial_call(double Su, double Sd, double K) {
+        FINCRAFTR_PROBE("options::payoff_binomial_call", 1);
         double Cu = (Su > K) ? (Su - K) : 0.0;
         double Cd = (Sd > K) ? (Sd - K) : 0.0;
         return std::make_pair(Cu, Cd);
@@ -21,6 +25,7 @@ namespace fc::options {
     /// @param Sd Stock price in down state
     /// @return Hedge ratio (number of shares to hold)
     inline double hedge_ratio_binomial(double Cu, double Cd, double Su, double Sd) {
+        FINCRAFTR_PROBE("options::hedge_ratio_binomial", 1);
         return (Cu - Cd) / (Su - Sd);
     }
 
@@ -32,23 +37,28 @@ namespace fc::options {
     /// @param r Risk-free rate
     /// @return Loan amount (negative means lending)
     inline double loan_binomial(double Cu, double Cd, double Su, double Sd, double r) {
+        FINCRAFTR_PROBE("options::loan_binomial", 1);
         double delta = hedge_ratio_binomial(Cu, Cd, Su, Sd);
         return (delta * Sd - Cd) / (1.0 + r);
     }
 
     /// Price option using one-period binomial replication
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S0 Current stock price
     /// @param Delta Hedge ratio (number of shares)
     /// @param B_hat Loan amount
     /// @param r Risk-free rate
     /// @param tau Time to expiration (default 1.0)
     /// @return Option price
+    template <class Math = fc::math::exact>
     inline double price_binomial_one_period(double S0, double Delta, double B_hat,
                                             double r, double tau=1.0) {
-        return Delta * S0 - std::pow(1.0 + r, tau) * B_hat;
+        FINCRAFTR_PROBE("options::price_binomial_one_period", 1);
+        return Delta * S0 - fc::math::pow<Math>(1.0 + r, tau) * B_hat;
     }
 
     /// Price option using risk-neutral valuation in one-period binomial model
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param S0 Current stock price
     /// @param Su Stock price in up state
     /// @param Sd Stock price in down state
@@ -57,12 +67,14 @@ namespace fc::options {
     /// @param r Risk-free rate
     /// @param tau Time to expiration (default 1.0)
     /// @return Option price
+    template <class Math = fc::math::exact>
     inline double price_risk_neutral_one_period(double S0, double Su, double Sd,
                                                 double Cu, double Cd,
                                                 double r, double tau=1.0) {
+        FINCRAFTR_PROBE("options::price_risk_neutral_one_period", 1);
         double u = Su / S0, d = Sd / S0;
-        double p_star = (std::exp(r * tau) - d) / (u - d);
+        double p_star = (fc::math::exp<Math>(r * tau) - d) / (u - d);
         double expected_payoff = p_star * Cu + (1.0 - p_star) * Cd;
-        return std::exp(-r * tau) * expected_payoff;
+        return fc::math::exp<Math>(-r * tau) * expected_payoff;
     }
 }
\ No newline at end of file
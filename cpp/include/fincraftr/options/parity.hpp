@@ -1,8 +1,12 @@
 #pragma once
 
 #include <cmath>
+
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
 namespace fc::options {
     /// Check if put-call parity relationship holds within tolerance
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param C Call option price
     /// @param P Put option price
     /// @param S Current stock price
@@ -13,17 +17,19 @@ namespace fc::options {
     /// @param q Continuous dividend yield (default NAN, uses discrete dividends)
     /// @param tol Tolerance for parity check (default 1e-8)
     /// @return True if parity holds within tolerance
+    template <class Math = fc::math::exact>
     inline bool check_put_call_parity(double C, double P, double S, double K,
                                     double r, double tau,
                                     double D=0.0, double q=NAN,
                                     double tol=1e-8) {
+        FINCRAFTR_PROBE("options::check_put_call_parity", 1);
         double lhs, rhs;
         if (std::isnan(q)) {
             lhs = P + S;
-            rhs = C + D + K * std::exp(-r * tau);
+            rhs = C + D + K * fc::math::exp<Math>(-r * tau);
         } else {
-            lhs = P + S * std::exp((q - r) * tau);
-            rhs = C + K * std::exp(-r * tau);
+            lhs = P + S * fc::math::exp<Math>((q - r) * tau);
+            rhs = C + K * fc::math::exp<Math>(-r * tau);
         }
         return std::abs(lhs - rhs) < tol;
     }
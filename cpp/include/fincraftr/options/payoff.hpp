@@ -1,4 +1,5 @@
 #pragma once
+#include "../core/instrument.hpp"
 
 namespace fc::options {
     /// Calculate the payoff of a European call option at expiration
@@ -6,6 +7,7 @@ namespace fc::options {
     /// @param K Strike price
     /// @return Call option payoff: max(ST - K, 0)
     inline double payoff_call(double ST, double K) {
+        FINCRAFTR_PROBE("options::payoff_call", 1);
         return (ST > K) ? (ST - K) : 0.0;
     }
 
@@ -14,6 +16,7 @@ namespace fc::options {
     /// @param K Strike price
     /// @return Put option payoff: max(K - ST, 0)
     inline double payoff_put(double ST, double K) {
+        FINCRAFTR_PROBE("options::payoff_put", 1);
         return (ST < K) ? (K - ST) : 0.0;
     }
 
@@ -22,6 +25,7 @@ namespace fc::options {
     /// @param K Strike price
     /// @return Asian call option payoff: max(average_price - K, 0)
     inline double payoff_asian_call(double average_price, double K) {
+        FINCRAFTR_PROBE("options::payoff_asian_call", 1);
         return (average_price > K) ? (average_price - K) : 0.0;
     }
 }
\ No newline at end of file
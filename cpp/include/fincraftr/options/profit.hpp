@@ -1,18 +1,24 @@
 #pragma once
 
 #include <cmath>
+
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
 namespace fc::options {
     /// Calculate profit/loss from holding a call option to expiration
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param ST Stock price at expiration
     /// @param K Strike price
     /// @param premium Option premium paid
     /// @param r Risk-free rate (continuous)
     /// @param tau Time to expiration
     /// @return Profit/loss including opportunity cost of premium
+    template <class Math = fc::math::exact>
     inline double profit_call(double ST, double K, double premium,
                             double r, double tau) {
+        FINCRAFTR_PROBE("options::profit_call", 1);
         double payoff = (ST > K) ? (ST - K) : 0.0;
-        double cost = premium * std::exp(r * tau);
+        double cost = premium * fc::math::exp<Math>(r * tau);
         return payoff - cost;
     }
 }
@@ -1,23 +1,32 @@
 #pragma once
 #include <cmath>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::rates {
     /// Calculate compound interest with discrete compounding
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param p0 Initial principal amount
     /// @param r Annual interest rate (as decimal, e.g., 0.05 for 5%)
     /// @param m Number of compounding periods per year
     /// @param years Time period in years
     /// @return Final amount after compound interest
+    template <class Math = fc::math::exact>
     inline double compound_discrete(double p0, double r, int m, double years) {
-        return p0 * std::pow(1 + r / m, m * years);
+        FINCRAFTR_PROBE("rates::compound_discrete", 1);
+        return p0 * fc::math::pow<Math>(1 + r / m, m * years);
     }
 
     /// Calculate compound interest with continuous compounding
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param p0 Initial principal amount
     /// @param r Annual interest rate (as decimal, e.g., 0.05 for 5%)
     /// @param t Time period in years
     /// @return Final amount after continuous compound interest
+    template <class Math = fc::math::exact>
     inline double compound_continuous(double p0, double r, double t) {
-        return p0 * std::exp(r * t);
+        FINCRAFTR_PROBE("rates::compound_continuous", 1);
+        return p0 * fc::math::exp<Math>(r * t);
     }
 }
\ No newline at end of file
@@ -1,20 +1,29 @@
 #pragma once
 #include <cmath>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::rates {
     /// Convert nominal (discrete) interest rate to continuous compounding rate
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param R Nominal annual interest rate (as decimal)
     /// @param m Number of compounding periods per year
     /// @return Equivalent continuous compounding rate
+    template <class Math = fc::math::exact>
     inline double nominal_to_continuous(double R, double m) {
-        return m * std::log(1 + R / m);
+        FINCRAFTR_PROBE("rates::nominal_to_continuous", 1);
+        return m * fc::math::log<Math>(1 + R / m);
     }
 
     /// Convert continuous compounding rate to nominal (discrete) interest rate
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param r Continuous compounding rate (as decimal)
     /// @param m Number of compounding periods per year
     /// @return Equivalent nominal annual interest rate
+    template <class Math = fc::math::exact>
     inline double continuous_to_nominal(double r, double m) {
-        return m * (std::exp(r / m) - 1);
+        FINCRAFTR_PROBE("rates::continuous_to_nominal", 1);
+        return m * (fc::math::exp<Math>(r / m) - 1);
     }
 }
\ No newline at end of file
@@ -1,23 +1,32 @@
 #pragma once
 #include <cmath>
 
+#include "../core/instrument.hpp"
+#include "../core/math.hpp"
+
 namespace fc::rates {
 
     /// Roll a value forward in time using continuous compounding
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param P_t Present value at time t
     /// @param r Continuous interest rate
     /// @param tau Time period to roll forward
     /// @return Future value after rolling forward tau time units
+    template <class Math = fc::math::exact>
     inline double roll_forward_cont(double P_t, double r, double tau) {
-        return P_t * std::exp(r * tau);
+        FINCRAFTR_PROBE("rates::roll_forward_cont", 1);
+        return P_t * fc::math::exp<Math>(r * tau);
     }
     
     /// Discount a value back in time using continuous compounding
+    /// @tparam Math Precision of exp, log and pow (fc::math::exact or fc::math::fast)
     /// @param P_t Future value at time t
     /// @param r Continuous interest rate
     /// @param tau Time period to discount back
     /// @return Present value after discounting back tau time units
+    template <class Math = fc::math::exact>
     inline double roll_back_cont(double P_t, double r, double tau) {
-        return P_t * std::exp(-r * tau);
+        FINCRAFTR_PROBE("rates::roll_back_cont", 1);
+        return P_t * fc::math::exp<Math>(-r * tau);
     }
 }
\ No newline at end of file
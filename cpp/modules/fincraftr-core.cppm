@@ -0,0 +1,161 @@
+/// fincraftr:core - async batch awaitables, error policies, validity bitmaps, math policies, instrumentation, tracing, batch and parallel helpers, market data store, valuation graph
+module;
+
+#include <fincraftr/core/async.hpp>
+#include <fincraftr/core/batch.hpp>
+#include <fincraftr/core/error.hpp>
+#include <fincraftr/core/instrument.hpp>
+#include <fincraftr/core/market_data.hpp>
+#include <fincraftr/core/math.hpp>
+#include <fincraftr/core/parallel.hpp>
+#include <fincraftr/core/shm_snapshot.hpp>
+#include <fincraftr/core/trace.hpp>
+#include <fincraftr/core/validity.hpp>
+#include <fincraftr/core/valuation_graph.hpp>
+#if defined(FINCRAFTR_MODULE_KERNELS)
+#include <fincraftr/core/kernels.hpp>
+#endif
+
+export module fincraftr:core;
+
+export namespace fc {
+    using fc::errc;
+    using fc::result;
+    using fc::collect_errors;
+    using fc::bitmap_view;
+}
+
+export namespace fc::policy {
+    using fc::policy::throwing;
+    using fc::policy::nan;
+    using fc::policy::status;
+}
+
+export namespace fc::math {
+    using fc::math::exact;
+    using fc::math::fast;
+    using fc::math::exp;
+    using fc::math::expm1;
+    using fc::math::log;
+    using fc::math::log1p;
+    using fc::math::pow;
+}
+
+export namespace fc::instrument {
+    using fc::instrument::max_sites;
+    using fc::instrument::histogram_buckets;
+    using fc::instrument::enabled;
+    using fc::instrument::function_stats;
+    using fc::instrument::snapshot;
+    using fc::instrument::reset;
+    using fc::instrument::ticks_per_ns;
+    using fc::instrument::report;
+}
+
+export namespace fc::trace {
+    using fc::trace::buffer_events;
+    using fc::trace::now;
+    using fc::trace::active;
+    using fc::trace::clear;
+    using fc::trace::start;
+    using fc::trace::stop;
+    using fc::trace::set_thread_name;
+    using fc::trace::intern;
+    using fc::trace::record;
+    using fc::trace::span;
+    using fc::trace::write_chrome_json;
+    using fc::trace::dump;
+}
+
+export namespace fc::parallel {
+    using fc::parallel::default_threads;
+    using fc::parallel::pool_options;
+    using fc::parallel::thread_pool;
+    using fc::parallel::parallel_for;
+}
+
+export namespace fc::async {
+    using fc::async::executor;
+    using fc::async::parallel_for;
+    using fc::async::map;
+    using fc::async::chunk_stream;
+    using fc::async::chunks;
+    using fc::async::run;
+}
+
+export namespace fc::market {
+    using fc::market::rate_curve;
+    using fc::market::dividend;
+    using fc::market::market_data;
+    using fc::market::market_data_options;
+    using fc::market::MarketDataStore;
+}
+
+export namespace fc::graph {
+    using fc::graph::node_id;
+    using fc::graph::ValuationGraph;
+}
+
+export namespace fc::batch {
+    using fc::batch::chunk_bytes;
+    using fc::batch::chunk_elements;
+    using fc::batch::operand;
+    using fc::batch::map;
+}
+
+#if defined(FINCRAFTR_HAS_SHM)
+export namespace fc::shm {
+    using fc::shm::max_ndim;
+    using fc::shm::snapshot_writer;
+    using fc::shm::snapshot;
+}
+#endif
+
+#if defined(FINCRAFTR_MODULE_KERNELS)
+export namespace fc::kernels {
+    using fc::kernels::isa;
+    using fc::kernels::market_cap;
+    using fc::kernels::ownership_fraction;
+    using fc::kernels::return_simple;
+    using fc::kernels::profit_simple;
+    using fc::kernels::profit_with_costs;
+    using fc::kernels::ddm_single_period;
+    using fc::kernels::cost_of_equity;
+    using fc::kernels::ddm_gordon_growth;
+    using fc::kernels::payoff_call;
+    using fc::kernels::payoff_put;
+    using fc::kernels::payoff_asian_call;
+    using fc::kernels::profit_call;
+    using fc::kernels::hedge_ratio_binomial;
+    using fc::kernels::loan_binomial;
+    using fc::kernels::price_binomial_one_period;
+    using fc::kernels::price_risk_neutral_one_period;
+    using fc::kernels::forward_price_no_div;
+    using fc::kernels::forward_price_with_div;
+    using fc::kernels::forward_price_cont_yield;
+    using fc::kernels::compound_discrete;
+    using fc::kernels::compound_continuous;
+    using fc::kernels::roll_forward_cont;
+    using fc::kernels::roll_back_cont;
+    using fc::kernels::nominal_to_continuous;
+    using fc::kernels::continuous_to_nominal;
+}
+
+export namespace fc::kernels::f32 {
+    using fc::kernels::f32::roll_back_cont;
+    using fc::kernels::f32::roll_forward_cont;
+    using fc::kernels::f32::compound_continuous;
+    using fc::kernels::f32::roll_back_cont_sum;
+    using fc::kernels::f32::forward_price_no_div;
+    using fc::kernels::f32::forward_price_with_div;
+    using fc::kernels::f32::forward_price_cont_yield;
+    using fc::kernels::f32::payoff_call;
+    using fc::kernels::f32::payoff_put;
+    using fc::kernels::f32::payoff_asian_call;
+    using fc::kernels::f32::profit_call;
+    using fc::kernels::f32::payoff_call_sum;
+    using fc::kernels::f32::payoff_put_sum;
+    using fc::kernels::f32::hedge_ratio_binomial;
+    using fc::kernels::f32::price_risk_neutral_one_period;
+}
+#endif
@@ -0,0 +1,63 @@
+/// fincraftr:equity - fc::equity functions and engines
+module;
+
+#include <fincraftr/equity/attribution.hpp>
+#include <fincraftr/equity/basic.hpp>
+#include <fincraftr/equity/dcf.hpp>
+#include <fincraftr/equity/index.hpp>
+#include <fincraftr/equity/ownership.hpp>
+#include <fincraftr/equity/pnl_book.hpp>
+#include <fincraftr/equity/profit.hpp>
+#include <fincraftr/equity/returns.hpp>
+#include <fincraftr/equity/valuation.hpp>
+
+export module fincraftr:equity;
+
+export namespace fc::equity {
+    // basic.hpp
+    using fc::equity::market_cap;
+    using fc::equity::ownership_fraction;
+
+    // returns.hpp, profit.hpp
+    using fc::equity::return_simple;
+    using fc::equity::profit_simple;
+    using fc::equity::profit_with_costs;
+
+    // valuation.hpp
+    using fc::equity::ddm_single_period;
+    using fc::equity::ddm_multi_period;
+    using fc::equity::ddm_infinite;
+    using fc::equity::cost_of_equity;
+    using fc::equity::ddm_gordon_growth;
+
+    // index.hpp
+    using fc::equity::index_price_weighted;
+    using fc::equity::index_cap_weighted;
+    using fc::equity::index_value_line_geo;
+    using fc::equity::index_value_line_arith;
+
+    // dcf.hpp
+    using fc::equity::dcf_two_stage;
+    using fc::equity::DcfDrivers;
+    using fc::equity::DcfCompany;
+    using fc::equity::DcfMonteCarloConfig;
+    using fc::equity::DcfDistribution;
+    using fc::equity::dcf_monte_carlo;
+
+    // attribution.hpp
+    using fc::equity::AttributionHoldings;
+    using fc::equity::BrinsonAttribution;
+    using fc::equity::returns_simple;
+    using fc::equity::brinson_fachler;
+    using fc::equity::brinson_fachler_batch;
+
+    // ownership.hpp
+    using fc::equity::Shareholding;
+    using fc::equity::LookThroughOptions;
+    using fc::equity::LookThroughResult;
+    using fc::equity::OwnershipGraph;
+
+    // pnl_book.hpp
+    using fc::equity::PnlLot;
+    using fc::equity::PnlBook;
+}
@@ -0,0 +1,12 @@
+/// fincraftr:forwards - fc::forwards pricing
+module;
+
+#include <fincraftr/forwards/pricing.hpp>
+
+export module fincraftr:forwards;
+
+export namespace fc::forwards {
+    using fc::forwards::forward_price_no_div;
+    using fc::forwards::forward_price_with_div;
+    using fc::forwards::forward_price_cont_yield;
+}
@@ -0,0 +1,22 @@
+/// fincraftr:options - fc::options payoffs, profits and binomial pricing
+module;
+
+#include <fincraftr/options/binomial.hpp>
+#include <fincraftr/options/parity.hpp>
+#include <fincraftr/options/payoff.hpp>
+#include <fincraftr/options/profit.hpp>
+
+export module fincraftr:options;
+
+export namespace fc::options {
+    using fc::options::payoff_call;
+    using fc::options::payoff_put;
+    using fc::options::payoff_asian_call;
+    using fc::options::profit_call;
+    using fc::options::check_put_call_parity;
+    using fc::options::payoff_binomial_call;
+    using fc::options::hedge_ratio_binomial;
+    using fc::options::loan_binomial;
+    using fc::options::price_binomial_one_period;
+    using fc::options::price_risk_neutral_one_period;
+}
@@ -0,0 +1,17 @@
+/// fincraftr:rates - fc::rates compounding, discounting and conversions
+module;
+
+#include <fincraftr/rates/compounding.hpp>
+#include <fincraftr/rates/conversions.hpp>
+#include <fincraftr/rates/discount.hpp>
+
+export module fincraftr:rates;
+
+export namespace fc::rates {
+    using fc::rates::compound_discrete;
+    using fc::rates::compound_continuous;
+    using fc::rates::roll_forward_cont;
+    using fc::rates::roll_back_cont;
+    using fc::rates::nominal_to_continuous;
+    using fc::rates::continuous_to_nominal;
+}
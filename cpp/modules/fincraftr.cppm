@@ -0,0 +1,15 @@
+/// Primary interface of the fincraftr named module
+///
+/// `import fincraftr;` makes every public name of the library available, exactly as the
+/// headers declare it (fc::equity::market_cap, fc::parallel::parallel_for, ...). Each
+/// namespace lives in its own partition, and the standard library headers the library
+/// uses are parsed once when the module is built instead of in every consumer.
+/// Macros do not cross a module boundary: consumers that test FINCRAFTR_HAS_SHM must
+/// include <fincraftr/core/shm_snapshot.hpp> for it.
+export module fincraftr;
+
+export import :core;
+export import :equity;
+export import :options;
+export import :forwards;
+export import :rates;
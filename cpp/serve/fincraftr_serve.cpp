@@ -0,0 +1,486 @@
+/**
+ * fincraftr-serve: the compiled batch kernels over a Unix domain socket
+ *
+ * Lets processes that cannot link the library price batches locally. Clients send
+ * length-prefixed binary frames (see protocol.hpp) and may pipeline any number of requests
+ * on one connection; responses come back in order.
+ *
+ * Every event-loop thread waits on one shared epoll set in which each connection is
+ * registered EPOLLONESHOT, so a connection is served by one thread at a time while
+ * different connections run in parallel. A thread reads what is available, evaluates every
+ * complete frame in the buffer and writes all responses with one send, which amortises the
+ * system calls over pipelined requests. Batches of at least --split elements are further
+ * cut into chunks for the shared fc::parallel pool. Inputs are read from, and outputs
+ * written to, the connection buffers in place: frames are 16 + 8k bytes, so every payload
+ * is 8-byte aligned and goes to the kernel without a copy.
+ *
+ * Build: cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DFINCRAFTR_HEADER_ONLY=OFF -DFINCRAFTR_BUILD_SERVER=ON
+ *        cmake --build build --target fincraftr-serve
+ *
+ * Usage: fincraftr-serve --socket PATH [--threads N] [--split ELEMENTS] [--max-frame BYTES] [--pin] [--list]
+ *
+ * --pin pins the workers of the shared pool, which run the split batches, one per CPU.
+ *
+ * SIGINT or SIGTERM stops the server and removes the socket file.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <fincraftr/core/kernels.hpp>
+#include <fincraftr/core/parallel.hpp>
+#include <fincraftr/core/trace.hpp>
+
+#include "protocol.hpp"
+
+namespace {
+    using fc::serve::function;
+    using fc::serve::status;
+
+    using runner = void (*)(std::size_t n, const double* const* in, double* out);
+
+    struct entry {
+        function id;
+        const char* name;
+        std::size_t arity;
+        runner run;
+    };
+
+    template <class... P>
+    constexpr std::size_t arity_of(void (*)(std::size_t, P...)) { return sizeof...(P) - 1; }
+
+    template <auto Kernel, std::size_t... I>
+    void call(std::size_t n, const double* const* in, double* out, std::index_sequence<I...>) {
+        Kernel(n, in[I]..., out);
+    }
+
+    template <auto Kernel>
+    void run(std::size_t n, const double* const* in, double* out) {
+        call<Kernel>(n, in, out, std::make_index_sequence<arity_of(Kernel)>{});
+    }
+
+#define FINCRAFTR_SERVE_ENTRY(name) entry{function::name, #name, arity_of(&fc::kernels::name), &run<&fc::kernels::name>}
+
+    constexpr std::array functions{
+        FINCRAFTR_SERVE_ENTRY(market_cap),
+        FINCRAFTR_SERVE_ENTRY(ownership_fraction),
+        FINCRAFTR_SERVE_ENTRY(return_simple),
+        FINCRAFTR_SERVE_ENTRY(profit_simple),
+        FINCRAFTR_SERVE_ENTRY(profit_with_costs),
+        FINCRAFTR_SERVE_ENTRY(ddm_single_period),
+        FINCRAFTR_SERVE_ENTRY(cost_of_equity),
+        FINCRAFTR_SERVE_ENTRY(ddm_gordon_growth),
+        FINCRAFTR_SERVE_ENTRY(payoff_call),
+        FINCRAFTR_SERVE_ENTRY(payoff_put),
+        FINCRAFTR_SERVE_ENTRY(payoff_asian_call),
+        FINCRAFTR_SERVE_ENTRY(profit_call),
+        FINCRAFTR_SERVE_ENTRY(hedge_ratio_binomial),
+        FINCRAFTR_SERVE_ENTRY(loan_binomial),
+        FINCRAFTR_SERVE_ENTRY(price_binomial_one_period),
+        FINCRAFTR_SERVE_ENTRY(price_risk_neutral_one_period),
+        FINCRAFTR_SERVE_ENTRY(forward_price_no_div),
+        FINCRAFTR_SERVE_ENTRY(forward_price_with_div),
+        FINCRAFTR_SERVE_ENTRY(forward_price_cont_yield),
+        FINCRAFTR_SERVE_ENTRY(compound_discrete),
+        FINCRAFTR_SERVE_ENTRY(compound_continuous),
+        FINCRAFTR_SERVE_ENTRY(roll_forward_cont),
+        FINCRAFTR_SERVE_ENTRY(roll_back_cont),
+        FINCRAFTR_SERVE_ENTRY(nominal_to_continuous),
+        FINCRAFTR_SERVE_ENTRY(continuous_to_nominal),
+    };
+
+#undef FINCRAFTR_SERVE_ENTRY
+
+    /// Most inputs of any served function (price_risk_neutral_one_period)
+    constexpr std::size_t max_arity = 7;
+    static_assert(std::all_of(functions.begin(), functions.end(), [](const entry& e) { return e.arity <= max_arity; }));
+
+    /// Function ids are sparse and below 256, so a flat table indexes them directly
+    struct lookup_table {
+        std::array<const entry*, 256> by_id{};
+
+        lookup_table() {
+            for (const entry& e : functions) by_id[static_cast<std::uint16_t>(e.id)] = &e;
+        }
+
+        const entry* find(std::uint16_t id) const { return id < by_id.size() ? by_id[id] : nullptr; }
+    };
+
+    struct options {
+        std::string socket_path;
+        unsigned threads = 0;
+        std::size_t split = 1u << 16;
+        std::uint32_t max_frame = fc::serve::default_max_frame;
+        bool pin = false;
+    };
+
+    [[noreturn]] void fail(const char* what) { throw std::system_error(errno, std::generic_category(), what); }
+
+    /// Byte buffer whose storage is 16-byte aligned (operator new), so doubles at 8-byte
+    /// offsets in it are aligned
+    class buffer {
+    public:
+        std::byte* data() { return data_.data(); }
+        std::size_t begin() const { return begin_; }
+        std::size_t end() const { return end_; }
+        std::size_t available() const { return end_ - begin_; }
+        std::size_t capacity() const { return data_.size(); }
+
+        /// Make room for at least n more bytes after end(). Unconsumed bytes move towards
+        /// offset 0 by a multiple of 16, so offsets keep their alignment.
+        void reserve_tail(std::size_t n) {
+            if (begin_ == end_) begin_ = end_ = 0;
+            if (data_.size() - end_ >= n) return;
+            const std::size_t shift = begin_ & ~std::size_t{15};
+            if (shift != 0) {
+                std::memmove(data_.data(), data_.data() + shift, end_ - shift);
+                begin_ -= shift;
+                end_ -= shift;
+            }
+            if (data_.size() - end_ < n) data_.resize(std::max(end_ + n, data_.size() * 2));
+        }
+
+        /// Append n uninitialised bytes
+        /// @return Offset of the first of them
+        std::size_t grow(std::size_t n) {
+            reserve_tail(n);
+            const std::size_t at = end_;
+            end_ += n;
+            return at;
+        }
+
+        void produced(std::size_t n) { end_ += n; }
+        void truncate(std::size_t end) { end_ = end; }
+        void consumed(std::size_t n) { begin_ += n; }
+
+        /// Release memory of a buffer that grew for one large frame
+        void shrink(std::size_t keep) {
+            if (begin_ == end_ && data_.size() > keep) {
+                data_ = std::vector<std::byte>(keep);
+                begin_ = end_ = 0;
+            }
+        }
+
+    private:
+        std::vector<std::byte> data_ = std::vector<std::byte>(64 * 1024);
+        std::size_t begin_ = 0;
+        std::size_t end_ = 0;
+    };
+
+    struct connection {
+        int fd;
+        buffer in;
+        buffer out;
+        bool closing = false;  ///< Stop reading: peer closed or stream error; close once out drains
+        /// Bumped before each re-arm: the kernel hands the connection to the next thread, and
+        /// this release/acquire pair makes the handoff visible to the C++ memory model too
+        std::atomic<std::uint32_t> handoff{0};
+    };
+
+    class server {
+    public:
+        server(options opt) : opt_(std::move(opt)) {
+            if (opt_.socket_path.size() >= sizeof(sockaddr_un::sun_path))
+                throw std::invalid_argument("socket path too long: " + opt_.socket_path);
+            listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listen_fd_ < 0) fail("socket");
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, opt_.socket_path.c_str(), opt_.socket_path.size() + 1);
+            ::unlink(opt_.socket_path.c_str());
+            if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) fail("bind");
+            if (::listen(listen_fd_, SOMAXCONN) != 0) fail("listen");
+
+            epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd_ < 0) fail("epoll_create1");
+            stop_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (stop_fd_ < 0) fail("eventfd");
+            // Both level-triggered and without data.ptr, which marks them apart from connections
+            watch(listen_fd_, EPOLLIN, nullptr, EPOLL_CTL_ADD);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.ptr = &stop_fd_;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &ev) != 0) fail("epoll_ctl");
+        }
+
+        ~server() {
+            ::close(epoll_fd_);
+            ::close(stop_fd_);
+            ::close(listen_fd_);
+            ::unlink(opt_.socket_path.c_str());
+            for (connection* c : live_) {
+                ::close(c->fd);
+                delete c;
+            }
+        }
+
+        /// Serve on `threads` event-loop threads until stop() is called
+        void run(unsigned threads) {
+            std::vector<std::thread> loops;
+            for (unsigned i = 0; i < threads; ++i)
+                loops.emplace_back([this, i] {
+                    fc::trace::set_thread_name("fincraftr-serve loop " + std::to_string(i));
+                    loop();
+                });
+            for (std::thread& t : loops) t.join();
+        }
+
+        /// Wake every loop thread and make it return; async-signal-safe
+        void stop() {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] ssize_t ignored = ::write(stop_fd_, &one, sizeof(one));
+        }
+
+    private:
+        void watch(int fd, std::uint32_t events, connection* c, int op) {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.ptr = c;
+            if (::epoll_ctl(epoll_fd_, op, fd, &ev) != 0) fail("epoll_ctl");
+        }
+
+        void loop() {
+            std::array<epoll_event, 64> events;
+            for (;;) {
+                const int n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    fail("epoll_wait");
+                }
+                for (int k = 0; k < n; ++k) {
+                    void* tag = events[k].data.ptr;
+                    if (tag == &stop_fd_) return;  // level-triggered: every thread sees it
+                    if (tag == nullptr) accept_all();
+                    else serve(static_cast<connection*>(tag), events[k].events);
+                }
+            }
+        }
+
+        void accept_all() {
+            for (;;) {
+                const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        std::fprintf(stderr, "fincraftr-serve: accept: %s\n", std::strerror(errno));
+                    return;  // another thread may have taken it
+                }
+                auto* c = new connection{fd, {}, {}};
+                {
+                    std::lock_guard<std::mutex> lock(live_mutex_);
+                    live_.push_back(c);
+                }
+                watch(fd, EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, c, EPOLL_CTL_ADD);
+            }
+        }
+
+        void close_connection(connection* c) {
+            ::close(c->fd);  // also removes it from the epoll set
+            {
+                std::lock_guard<std::mutex> lock(live_mutex_);
+                live_.erase(std::find(live_.begin(), live_.end(), c));
+            }
+            delete c;
+        }
+
+        // Runs on one thread at a time per connection (EPOLLONESHOT)
+        void serve(connection* c, std::uint32_t events) {
+            static_cast<void>(c->handoff.load(std::memory_order_acquire));
+            if (events & EPOLLERR) return close_connection(c);
+            if (!c->closing && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                c->in.reserve_tail(64 * 1024);
+                const std::size_t room = c->in.capacity() - c->in.end();
+                const ssize_t got = ::recv(c->fd, c->in.data() + c->in.end(), room, 0);
+                if (got > 0) {
+                    c->in.produced(static_cast<std::size_t>(got));
+                    process(*c);
+                } else if (got == 0) {
+                    c->closing = true;
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    return close_connection(c);
+                }
+            }
+            if (!flush(*c)) return close_connection(c);
+            if (c->closing && c->out.available() == 0) return close_connection(c);
+            c->in.shrink(64 * 1024);
+            c->out.shrink(64 * 1024);
+            // Back-pressure: a client that does not read its responses is not read from either
+            std::uint32_t want = EPOLLRDHUP | EPOLLONESHOT;
+            if (c->out.available() != 0) want |= EPOLLOUT;
+            if (!c->closing && c->out.available() < (4u << 20)) want |= EPOLLIN;
+            c->handoff.fetch_add(1, std::memory_order_release);
+            watch(c->fd, want, c, EPOLL_CTL_MOD);
+        }
+
+        /// @return False if the peer is gone
+        bool flush(connection& c) {
+            while (c.out.available() != 0) {
+                const ssize_t sent = ::send(c.fd, c.out.data() + c.out.begin(), c.out.available(), MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno == EINTR) continue;
+                    return errno == EAGAIN || errno == EWOULDBLOCK;
+                }
+                c.out.consumed(static_cast<std::size_t>(sent));
+            }
+            return true;
+        }
+
+        void respond_error(connection& c, std::uint32_t id, status s) {
+            const std::size_t at = c.out.grow(fc::serve::header_size);
+            const fc::serve::response_header h{12, id, static_cast<std::uint16_t>(s), 0, 0};
+            std::memcpy(c.out.data() + at, &h, sizeof(h));
+        }
+
+        // Evaluate every complete frame in the input buffer
+        void process(connection& c) {
+            while (!c.closing && c.in.available() >= sizeof(std::uint32_t)) {
+                const std::byte* frame = c.in.data() + c.in.begin();
+                std::uint32_t length;
+                std::memcpy(&length, frame, sizeof(length));
+                const bool too_large = length > opt_.max_frame;
+                if (too_large || length < fc::serve::header_size - 4 || (length - 12) % sizeof(double) != 0) {
+                    std::uint32_t id = 0;
+                    if (c.in.available() >= 8) std::memcpy(&id, frame + 4, sizeof(id));
+                    respond_error(c, id, too_large ? status::frame_too_large : status::bad_length);
+                    c.closing = true;
+                    return;
+                }
+                const std::size_t size = 4 + static_cast<std::size_t>(length);
+                if (c.in.available() < size) {
+                    // Grow once for a large frame rather than in 64 KiB steps
+                    c.in.reserve_tail(size - c.in.available());
+                    return;
+                }
+                fc::serve::request_header h;
+                std::memcpy(&h, frame, sizeof(h));
+                evaluate(c, h, reinterpret_cast<const double*>(frame + fc::serve::header_size));
+                c.in.consumed(size);
+            }
+        }
+
+        void evaluate(connection& c, const fc::serve::request_header& h, const double* payload) {
+            if (h.function == static_cast<std::uint16_t>(function::ping)) {
+                if (h.length != 12) return respond_error(c, h.id, status::bad_length);
+                return respond_error(c, h.id, status::ok);
+            }
+            const entry* e = table_.find(h.function);
+            if (e == nullptr) return respond_error(c, h.id, status::unknown_function);
+            const std::size_t n = h.count;
+            if (h.length != 12 + sizeof(double) * e->arity * n) return respond_error(c, h.id, status::bad_length);
+
+            FINCRAFTR_TRACE_SPAN("serve::evaluate", n);
+            // grow() may move the output buffer but not the input the payload points into
+            const std::size_t at = c.out.grow(fc::serve::header_size + sizeof(double) * n);
+            double* out = reinterpret_cast<double*>(c.out.data() + at + fc::serve::header_size);
+            std::array<const double*, max_arity> in{};
+            for (std::size_t k = 0; k < e->arity; ++k) in[k] = payload + k * n;
+            fc::serve::response_header r{static_cast<std::uint32_t>(12 + sizeof(double) * n), h.id,
+                                         static_cast<std::uint16_t>(status::ok), 0, h.count};
+            try {
+                if (n < opt_.split) {
+                    e->run(n, in.data(), out);
+                } else {
+                    fc::parallel::parallel_for(n, opt_.split / 4, 0, [&](std::size_t b, std::size_t end) {
+                        std::array<const double*, max_arity> part{};
+                        for (std::size_t k = 0; k < e->arity; ++k) part[k] = in[k] + b;
+                        e->run(end - b, part.data(), out + b);
+                    });
+                }
+            } catch (const std::exception& ex) {
+                std::fprintf(stderr, "fincraftr-serve: %s: %s\n", e->name, ex.what());
+                r = {12, h.id, static_cast<std::uint16_t>(status::failed), 0, 0};
+                c.out.truncate(at + fc::serve::header_size);
+            }
+            std::memcpy(c.out.data() + at, &r, sizeof(r));
+        }
+
+        options opt_;
+        lookup_table table_;
+        int listen_fd_ = -1;
+        int epoll_fd_ = -1;
+        int stop_fd_ = -1;
+        std::mutex live_mutex_;
+        std::vector<connection*> live_;  ///< Open connections, closed on shutdown
+    };
+}
+
+namespace {
+    int usage(const char* argv0) {
+        std::fprintf(stderr, "usage: %s --socket PATH [--threads N] [--split ELEMENTS] [--max-frame BYTES] [--pin] [--list]\n",
+                     argv0);
+        return 2;
+    }
+}
+
+int main(int argc, char** argv) {
+    options opt;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--list") list = true;
+        else if (arg == "--pin") opt.pin = true;
+        else if (arg == "--socket" && has_value) opt.socket_path = argv[++i];
+        else if (arg == "--threads" && has_value) opt.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--split" && has_value) opt.split = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-frame" && has_value) opt.max_frame = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else return usage(argv[0]);
+    }
+
+    if (list) {
+        std::printf("%5s  %-32s %s\n", "id", "function", "arity");
+        std::printf("%5u  %-32s %d\n", 0u, "ping", 0);
+        for (const entry& e : functions)
+            std::printf("%5u  %-32s %zu\n", static_cast<unsigned>(e.id), e.name, e.arity);
+        return 0;
+    }
+    if (opt.socket_path.empty()) return usage(argv[0]);
+    if (opt.split == 0) opt.split = 1;
+    if (opt.pin) fc::parallel::thread_pool::configure({.workers = 0, .pin = true, .cpus = {}});
+    const unsigned threads = opt.threads == 0 ? fc::parallel::default_threads() : opt.threads;
+
+    // Only the main thread takes SIGINT/SIGTERM; the loop threads inherit the blocked mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        server srv(opt);
+        std::fprintf(stderr, "fincraftr-serve: listening on %s with %u threads (kernels: %s)\n",
+                     opt.socket_path.c_str(), threads, fc::kernels::isa());
+        std::thread loops([&] { srv.run(threads); });
+        int sig = 0;
+        sigwait(&signals, &sig);
+        srv.stop();
+        loops.join();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "fincraftr-serve: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
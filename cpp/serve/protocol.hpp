@@ -0,0 +1,97 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/// Wire format of fincraftr-serve
+///
+/// A connection carries a stream of frames in each direction; clients may pipeline any
+/// number of requests before reading responses. Every integer and double is little-endian
+/// and every frame is a 16-byte header followed by a payload of doubles:
+///
+///     request:  u32 length | u32 id | u16 function | u16 flags (0) | u32 count | inputs
+///     response: u32 length | u32 id | u16 status   | u16 reserved  | u32 count | outputs
+///
+/// length counts the bytes after the length field (12 + 8 * doubles). A request for a
+/// function of arity k carries k * count doubles, one column per argument: all count values
+/// of the first argument, then all of the second, and so on, in the argument order of the
+/// function in core/kernels.hpp. Its response carries count doubles, result i for element i,
+/// and echoes id. Responses on a connection come back in request order.
+///
+/// A request that cannot be served gets a response with a non-zero status and count 0.
+/// After status::frame_too_large or status::bad_length the server stops reading and closes
+/// the connection once the error is sent, because the stream can no longer be trusted.
+namespace fc::serve {
+    static_assert(std::endian::native == std::endian::little, "fincraftr-serve frames are little-endian");
+
+    /// Size of the request and response headers, including the length field
+    inline constexpr std::size_t header_size = 16;
+
+    /// Frames larger than this (length field) are refused unless the server is told otherwise
+    inline constexpr std::uint32_t default_max_frame = 64u << 20;
+
+    struct request_header {
+        std::uint32_t length;
+        std::uint32_t id;
+        std::uint16_t function;
+        std::uint16_t flags;
+        std::uint32_t count;
+    };
+
+    struct response_header {
+        std::uint32_t length;
+        std::uint32_t id;
+        std::uint16_t status;
+        std::uint16_t reserved;
+        std::uint32_t count;
+    };
+
+    static_assert(sizeof(request_header) == header_size && sizeof(response_header) == header_size);
+
+    enum class status : std::uint16_t {
+        ok = 0,
+        unknown_function = 1,  ///< No function with that id
+        bad_length = 2,        ///< length does not match 12 + 8 * arity * count
+        frame_too_large = 3,   ///< length above the server's --max-frame
+        failed = 4,            ///< The function threw (out of memory and the like)
+    };
+
+    /// Function ids; arguments as in core/kernels.hpp. Ids are stable: new functions get new ids.
+    enum class function : std::uint16_t {
+        ping = 0,  ///< Arity 0: returns an empty ok response, for liveness and latency checks
+
+        // Equity
+        market_cap = 1,
+        ownership_fraction = 2,
+        return_simple = 3,
+        profit_simple = 4,
+        profit_with_costs = 5,
+        ddm_single_period = 6,
+        cost_of_equity = 7,
+        ddm_gordon_growth = 8,
+
+        // Options
+        payoff_call = 20,
+        payoff_put = 21,
+        payoff_asian_call = 22,
+        profit_call = 23,
+        hedge_ratio_binomial = 24,
+        loan_binomial = 25,
+        price_binomial_one_period = 26,
+        price_risk_neutral_one_period = 27,
+
+        // Forwards
+        forward_price_no_div = 40,
+        forward_price_with_div = 41,
+        forward_price_cont_yield = 42,
+
+        // Rates
+        compound_discrete = 60,
+        compound_continuous = 61,
+        roll_forward_cont = 62,
+        roll_back_cont = 63,
+        nominal_to_continuous = 64,
+        continuous_to_nominal = 65,
+    };
+}
@@ -0,0 +1,432 @@
+#include <fincraftr/core/kernels.hpp>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <fincraftr/core/instrument.hpp>
+#include <fincraftr/core/trace.hpp>
+#include <fincraftr/equity/basic.hpp>
+#include <fincraftr/equity/profit.hpp>
+#include <fincraftr/equity/returns.hpp>
+#include <fincraftr/equity/valuation.hpp>
+#include <fincraftr/forwards/pricing.hpp>
+#include <fincraftr/options/binomial.hpp>
+#include <fincraftr/options/payoff.hpp>
+#include <fincraftr/options/profit.hpp>
+#include <fincraftr/rates/compounding.hpp>
+#include <fincraftr/rates/conversions.hpp>
+#include <fincraftr/rates/discount.hpp>
+
+// Function multiversioning: the compiler emits one clone per target plus an ifunc resolver
+// that the dynamic loader runs once to bind the best clone for the host CPU.
+// FINCRAFTR_DISPATCH_ARCH_LEVELS marks clones built for the psABI levels rather than single
+// features, so isa() probes the same levels the resolver picks from.
+#if defined(FINCRAFTR_NO_DISPATCH) || !(defined(__x86_64__) && defined(__ELF__))
+#define FINCRAFTR_DISPATCH
+#define FINCRAFTR_HAS_DISPATCH 0
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#define FINCRAFTR_DISPATCH \
+    __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "arch=x86-64-v2", "default")))
+#define FINCRAFTR_HAS_DISPATCH 1
+#define FINCRAFTR_DISPATCH_ARCH_LEVELS 1
+#elif (defined(__clang__) && __clang_major__ >= 14) || (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 6)
+#define FINCRAFTR_DISPATCH __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#define FINCRAFTR_HAS_DISPATCH 1
+#else
+#define FINCRAFTR_DISPATCH
+#define FINCRAFTR_HAS_DISPATCH 0
+#endif
+
+#if defined(__GNUC__)
+#define FINCRAFTR_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define FINCRAFTR_ALWAYS_INLINE inline
+#endif
+
+namespace {
+    // Inlined into each clone so the loop and the scalar function are compiled for its ISA
+    template <class F, class... In>
+    FINCRAFTR_ALWAYS_INLINE void apply(std::size_t n, double* out, F f, const In*... in) {
+        for (std::size_t i = 0; i < n; ++i) out[i] = f(in[i]...);
+    }
+
+    // Single precision: inputs are widened to double and results narrowed to float in
+    // separate loops a block at a time, so the loop calling f is the one the double kernels
+    // run. A conversion inside it can be sunk into a branch of f, and GCC will not
+    // if-convert a conversion that may trap.
+    constexpr std::size_t f32_block = 256;
+
+    template <std::size_t N>
+    FINCRAFTR_ALWAYS_INLINE void widen(std::size_t b, std::size_t m, double (&wide)[N][f32_block],
+                                       const std::array<const float*, N>& in) {
+        for (std::size_t k = 0; k < N; ++k)
+            for (std::size_t i = 0; i < m; ++i) wide[k][i] = in[k][b + i];
+    }
+
+    template <class F, std::size_t N, std::size_t... K>
+    FINCRAFTR_ALWAYS_INLINE void apply_f32(std::size_t n, float* out, F f, std::array<const float*, N> in,
+                                           std::index_sequence<K...>) {
+        double wide[N][f32_block];
+        double result[f32_block];
+        for (std::size_t b = 0; b < n; b += f32_block) {
+            const std::size_t m = std::min(f32_block, n - b);
+            widen(b, m, wide, in);
+            for (std::size_t i = 0; i < m; ++i) result[i] = f(wide[K][i]...);
+            for (std::size_t i = 0; i < m; ++i) out[b + i] = static_cast<float>(result[i]);
+        }
+    }
+
+    template <class F, class... In>
+    FINCRAFTR_ALWAYS_INLINE void apply_f32(std::size_t n, float* out, F f, const In*... in) {
+        apply_f32(n, out, f, std::array<const float*, sizeof...(In)>{in...}, std::index_sequence_for<In...>{});
+    }
+
+    // Sum of f over float inputs, accumulated in double. Eight independent accumulators let
+    // the loop vectorize without reassociating one running sum (which -O3 alone will not do).
+    template <class F, std::size_t N, std::size_t... K>
+    FINCRAFTR_ALWAYS_INLINE double sum_f32(std::size_t n, F f, std::array<const float*, N> in,
+                                           std::index_sequence<K...>) {
+        constexpr std::size_t lanes = 8;
+        double acc[lanes] = {};
+        double wide[N][f32_block];
+        for (std::size_t b = 0; b < n; b += f32_block) {
+            const std::size_t m = std::min(f32_block, n - b);
+            widen(b, m, wide, in);
+            std::size_t i = 0;
+            for (; i + lanes <= m; i += lanes)
+                for (std::size_t j = 0; j < lanes; ++j) acc[j] += f(wide[K][i + j]...);
+            for (; i < m; ++i) acc[i % lanes] += f(wide[K][i]...);
+        }
+        return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    }
+
+    template <class F, class... In>
+    FINCRAFTR_ALWAYS_INLINE double sum_f32(std::size_t n, F f, const In*... in) {
+        return sum_f32(n, f, std::array<const float*, sizeof...(In)>{in...}, std::index_sequence_for<In...>{});
+    }
+}
+
+namespace fc::kernels {
+    const char* isa() {
+#if FINCRAFTR_HAS_DISPATCH
+        __builtin_cpu_init();
+#if defined(FINCRAFTR_DISPATCH_ARCH_LEVELS)
+        if (__builtin_cpu_supports("x86-64-v4")) return "x86-64-v4";
+        if (__builtin_cpu_supports("x86-64-v3")) return "x86-64-v3";
+        if (__builtin_cpu_supports("x86-64-v2")) return "x86-64-v2";
+#else
+        if (__builtin_cpu_supports("avx512f")) return "avx512";
+        if (__builtin_cpu_supports("avx2")) return "avx2";
+        if (__builtin_cpu_supports("sse4.2")) return "sse4.2";
+#endif
+#endif
+        return "baseline";
+    }
+
+    // Equity
+    FINCRAFTR_DISPATCH
+    void market_cap(std::size_t n, const double* shares_outstanding, const double* price, double* out) {
+        FINCRAFTR_PROBE("kernels::market_cap", n);
+        FINCRAFTR_TRACE_SPAN("kernels::market_cap", n);
+        apply(n, out, &fc::equity::market_cap, shares_outstanding, price);
+    }
+
+    FINCRAFTR_DISPATCH
+    void ownership_fraction(std::size_t n, const double* shares_owned, const double* shares_outstanding, double* out) {
+        FINCRAFTR_PROBE("kernels::ownership_fraction", n);
+        FINCRAFTR_TRACE_SPAN("kernels::ownership_fraction", n);
+        apply(n, out, &fc::equity::ownership_fraction<fc::policy::nan>, shares_owned, shares_outstanding);
+    }
+
+    FINCRAFTR_DISPATCH
+    void return_simple(std::size_t n, const double* Pt, const double* Pt_prev, double* out) {
+        FINCRAFTR_PROBE("kernels::return_simple", n);
+        FINCRAFTR_TRACE_SPAN("kernels::return_simple", n);
+        apply(n, out, &fc::equity::return_simple<fc::policy::nan>, Pt, Pt_prev);
+    }
+
+    FINCRAFTR_DISPATCH
+    void profit_simple(std::size_t n, const double* S0, const double* ST, const double* r, const double* tau,
+                       double* out) {
+        FINCRAFTR_PROBE("kernels::profit_simple", n);
+        FINCRAFTR_TRACE_SPAN("kernels::profit_simple", n);
+        apply(n, out, &fc::equity::profit_simple<fc::math::fast>, S0, ST, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void profit_with_costs(std::size_t n, const double* S0, const double* ST, const double* r, const double* tau,
+                           const double* D_tau, const double* C0, double* out) {
+        FINCRAFTR_PROBE("kernels::profit_with_costs", n);
+        FINCRAFTR_TRACE_SPAN("kernels::profit_with_costs", n);
+        apply(n, out, &fc::equity::profit_with_costs<fc::math::fast>, S0, ST, r, tau, D_tau, C0);
+    }
+
+    FINCRAFTR_DISPATCH
+    void ddm_single_period(std::size_t n, const double* D1, const double* S1, const double* r, double* out) {
+        FINCRAFTR_PROBE("kernels::ddm_single_period", n);
+        FINCRAFTR_TRACE_SPAN("kernels::ddm_single_period", n);
+        apply(n, out, &fc::equity::ddm_single_period, D1, S1, r);
+    }
+
+    FINCRAFTR_DISPATCH
+    void cost_of_equity(std::size_t n, const double* D1, const double* S1, const double* S0, double* out) {
+        FINCRAFTR_PROBE("kernels::cost_of_equity", n);
+        FINCRAFTR_TRACE_SPAN("kernels::cost_of_equity", n);
+        apply(n, out, &fc::equity::cost_of_equity<fc::policy::nan>, D1, S1, S0);
+    }
+
+    FINCRAFTR_DISPATCH
+    void ddm_gordon_growth(std::size_t n, const double* D1, const double* r, const double* g, double* out) {
+        FINCRAFTR_PROBE("kernels::ddm_gordon_growth", n);
+        FINCRAFTR_TRACE_SPAN("kernels::ddm_gordon_growth", n);
+        apply(n, out, &fc::equity::ddm_gordon_growth<fc::policy::nan>, D1, r, g);
+    }
+
+    // Options
+    FINCRAFTR_DISPATCH
+    void payoff_call(std::size_t n, const double* ST, const double* K, double* out) {
+        FINCRAFTR_PROBE("kernels::payoff_call", n);
+        FINCRAFTR_TRACE_SPAN("kernels::payoff_call", n);
+        apply(n, out, &fc::options::payoff_call, ST, K);
+    }
+
+    FINCRAFTR_DISPATCH
+    void payoff_put(std::size_t n, const double* ST, const double* K, double* out) {
+        FINCRAFTR_PROBE("kernels::payoff_put", n);
+        FINCRAFTR_TRACE_SPAN("kernels::payoff_put", n);
+        apply(n, out, &fc::options::payoff_put, ST, K);
+    }
+
+    FINCRAFTR_DISPATCH
+    void payoff_asian_call(std::size_t n, const double* average_price, const double* K, double* out) {
+        FINCRAFTR_PROBE("kernels::payoff_asian_call", n);
+        FINCRAFTR_TRACE_SPAN("kernels::payoff_asian_call", n);
+        apply(n, out, &fc::options::payoff_asian_call, average_price, K);
+    }
+
+    FINCRAFTR_DISPATCH
+    void profit_call(std::size_t n, const double* ST, const double* K, const double* premium, const double* r,
+                     const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::profit_call", n);
+        FINCRAFTR_TRACE_SPAN("kernels::profit_call", n);
+        apply(n, out, &fc::options::profit_call<fc::math::fast>, ST, K, premium, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void hedge_ratio_binomial(std::size_t n, const double* Cu, const double* Cd, const double* Su, const double* Sd,
+                              double* out) {
+        FINCRAFTR_PROBE("kernels::hedge_ratio_binomial", n);
+        FINCRAFTR_TRACE_SPAN("kernels::hedge_ratio_binomial", n);
+        apply(n, out, &fc::options::hedge_ratio_binomial, Cu, Cd, Su, Sd);
+    }
+
+    FINCRAFTR_DISPATCH
+    void loan_binomial(std::size_t n, const double* Cu, const double* Cd, const double* Su, const double* Sd,
+                       const double* r, double* out) {
+        FINCRAFTR_PROBE("kernels::loan_binomial", n);
+        FINCRAFTR_TRACE_SPAN("kernels::loan_binomial", n);
+        apply(n, out, &fc::options::loan_binomial, Cu, Cd, Su, Sd, r);
+    }
+
+    FINCRAFTR_DISPATCH
+    void price_binomial_one_period(std::size_t n, const double* S0, const double* Delta, const double* B_hat,
+                                   const double* r, const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::price_binomial_one_period", n);
+        FINCRAFTR_TRACE_SPAN("kernels::price_binomial_one_period", n);
+        apply(n, out, &fc::options::price_binomial_one_period<fc::math::fast>, S0, Delta, B_hat, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void price_risk_neutral_one_period(std::size_t n, const double* S0, const double* Su, const double* Sd,
+                                       const double* Cu, const double* Cd, const double* r, const double* tau,
+                                       double* out) {
+        FINCRAFTR_PROBE("kernels::price_risk_neutral_one_period", n);
+        FINCRAFTR_TRACE_SPAN("kernels::price_risk_neutral_one_period", n);
+        apply(n, out, &fc::options::price_risk_neutral_one_period<fc::math::fast>, S0, Su, Sd, Cu, Cd, r, tau);
+    }
+
+    // Forwards
+    FINCRAFTR_DISPATCH
+    void forward_price_no_div(std::size_t n, const double* S, const double* r, const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::forward_price_no_div", n);
+        FINCRAFTR_TRACE_SPAN("kernels::forward_price_no_div", n);
+        apply(n, out, &fc::forwards::forward_price_no_div<fc::math::fast>, S, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void forward_price_with_div(std::size_t n, const double* S, const double* D, const double* r, const double* tau,
+                                double* out) {
+        FINCRAFTR_PROBE("kernels::forward_price_with_div", n);
+        FINCRAFTR_TRACE_SPAN("kernels::forward_price_with_div", n);
+        apply(n, out, &fc::forwards::forward_price_with_div<fc::math::fast>, S, D, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void forward_price_cont_yield(std::size_t n, const double* S, const double* r, const double* q,
+                                  const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::forward_price_cont_yield", n);
+        FINCRAFTR_TRACE_SPAN("kernels::forward_price_cont_yield", n);
+        apply(n, out, &fc::forwards::forward_price_cont_yield<fc::math::fast>, S, r, q, tau);
+    }
+
+    // Rates
+    FINCRAFTR_DISPATCH
+    void compound_discrete(std::size_t n, const double* p0, const double* r, const double* m, const double* years,
+                           double* out) {
+        FINCRAFTR_PROBE("kernels::compound_discrete", n);
+        FINCRAFTR_TRACE_SPAN("kernels::compound_discrete", n);
+        apply(n, out, [](double p0, double r, double m, double years) {
+            return fc::rates::compound_discrete<fc::math::fast>(p0, r, static_cast<int>(m), years);
+        }, p0, r, m, years);
+    }
+
+    FINCRAFTR_DISPATCH
+    void compound_continuous(std::size_t n, const double* p0, const double* r, const double* t, double* out) {
+        FINCRAFTR_PROBE("kernels::compound_continuous", n);
+        FINCRAFTR_TRACE_SPAN("kernels::compound_continuous", n);
+        apply(n, out, &fc::rates::compound_continuous<fc::math::fast>, p0, r, t);
+    }
+
+    FINCRAFTR_DISPATCH
+    void roll_forward_cont(std::size_t n, const double* P_t, const double* r, const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::roll_forward_cont", n);
+        FINCRAFTR_TRACE_SPAN("kernels::roll_forward_cont", n);
+        apply(n, out, &fc::rates::roll_forward_cont<fc::math::fast>, P_t, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void roll_back_cont(std::size_t n, const double* P_t, const double* r, const double* tau, double* out) {
+        FINCRAFTR_PROBE("kernels::roll_back_cont", n);
+        FINCRAFTR_TRACE_SPAN("kernels::roll_back_cont", n);
+        apply(n, out, &fc::rates::roll_back_cont<fc::math::fast>, P_t, r, tau);
+    }
+
+    FINCRAFTR_DISPATCH
+    void nominal_to_continuous(std::size_t n, const double* R, const double* m, double* out) {
+        FINCRAFTR_PROBE("kernels::nominal_to_continuous", n);
+        FINCRAFTR_TRACE_SPAN("kernels::nominal_to_continuous", n);
+        apply(n, out, &fc::rates::nominal_to_continuous<fc::math::fast>, R, m);
+    }
+
+    FINCRAFTR_DISPATCH
+    void continuous_to_nominal(std::size_t n, const double* r, const double* m, double* out) {
+        FINCRAFTR_PROBE("kernels::continuous_to_nominal", n);
+        FINCRAFTR_TRACE_SPAN("kernels::continuous_to_nominal", n);
+        apply(n, out, &fc::rates::continuous_to_nominal<fc::math::fast>, r, m);
+    }
+
+    // Single precision
+    namespace f32 {
+        FINCRAFTR_DISPATCH
+        void roll_back_cont(std::size_t n, const float* P_t, const float* r, const float* tau, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::roll_back_cont", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::roll_back_cont", n);
+            apply_f32(n, out, &fc::rates::roll_back_cont<fc::math::fast>, P_t, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void roll_forward_cont(std::size_t n, const float* P_t, const float* r, const float* tau, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::roll_forward_cont", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::roll_forward_cont", n);
+            apply_f32(n, out, &fc::rates::roll_forward_cont<fc::math::fast>, P_t, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void compound_continuous(std::size_t n, const float* p0, const float* r, const float* t, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::compound_continuous", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::compound_continuous", n);
+            apply_f32(n, out, &fc::rates::compound_continuous<fc::math::fast>, p0, r, t);
+        }
+
+        FINCRAFTR_DISPATCH
+        double roll_back_cont_sum(std::size_t n, const float* P_t, const float* r, const float* tau) {
+            FINCRAFTR_PROBE("kernels::f32::roll_back_cont_sum", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::roll_back_cont_sum", n);
+            return sum_f32(n, &fc::rates::roll_back_cont<fc::math::fast>, P_t, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void forward_price_no_div(std::size_t n, const float* S, const float* r, const float* tau, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::forward_price_no_div", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::forward_price_no_div", n);
+            apply_f32(n, out, &fc::forwards::forward_price_no_div<fc::math::fast>, S, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void forward_price_with_div(std::size_t n, const float* S, const float* D, const float* r, const float* tau,
+                                    float* out) {
+            FINCRAFTR_PROBE("kernels::f32::forward_price_with_div", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::forward_price_with_div", n);
+            apply_f32(n, out, &fc::forwards::forward_price_with_div<fc::math::fast>, S, D, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void forward_price_cont_yield(std::size_t n, const float* S, const float* r, const float* q,
+                                      const float* tau, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::forward_price_cont_yield", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::forward_price_cont_yield", n);
+            apply_f32(n, out, &fc::forwards::forward_price_cont_yield<fc::math::fast>, S, r, q, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        void payoff_call(std::size_t n, const float* ST, const float* K, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::payoff_call", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::payoff_call", n);
+            apply_f32(n, out, &fc::options::payoff_call, ST, K);
+        }
+
+        FINCRAFTR_DISPATCH
+        void payoff_put(std::size_t n, const float* ST, const float* K, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::payoff_put", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::payoff_put", n);
+            apply_f32(n, out, &fc::options::payoff_put, ST, K);
+        }
+
+        FINCRAFTR_DISPATCH
+        void payoff_asian_call(std::size_t n, const float* average_price, const float* K, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::payoff_asian_call", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::payoff_asian_call", n);
+            apply_f32(n, out, &fc::options::payoff_asian_call, average_price, K);
+        }
+
+        FINCRAFTR_DISPATCH
+        void profit_call(std::size_t n, const float* ST, const float* K, const float* premium, const float* r,
+                         const float* tau, float* out) {
+            FINCRAFTR_PROBE("kernels::f32::profit_call", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::profit_call", n);
+            apply_f32(n, out, &fc::options::profit_call<fc::math::fast>, ST, K, premium, r, tau);
+        }
+
+        FINCRAFTR_DISPATCH
+        double payoff_call_sum(std::size_t n, const float* ST, const float* K) {
+            FINCRAFTR_PROBE("kernels::f32::payoff_call_sum", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::payoff_call_sum", n);
+            return sum_f32(n, &fc::options::payoff_call, ST, K);
+        }
+
+        FINCRAFTR_DISPATCH
+        double payoff_put_sum(std::size_t n, const float* ST, const float* K) {
+            FINCRAFTR_PROBE("kernels::f32::payoff_put_sum", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::payoff_put_sum", n);
+            return sum_f32(n, &fc::options::payoff_put, ST, K);
+        }
+
+        FINCRAFTR_DISPATCH
+        void hedge_ratio_binomial(std::size_t n, const float* Cu, const float* Cd, const float* Su, const float* Sd,
+                                  float* out) {
+            FINCRAFTR_PROBE("kernels::f32::hedge_ratio_binomial", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::hedge_ratio_binomial", n);
+            apply_f32(n, out, &fc::options::hedge_ratio_binomial, Cu, Cd, Su, Sd);
+        }
+
+        FINCRAFTR_DISPATCH
+        void price_risk_neutral_one_period(std::size_t n, const float* S0, const float* Su, const float* Sd,
+                                           const float* Cu, const float* Cd, const float* r, const float* tau,
+                                           float* out) {
+            FINCRAFTR_PROBE("kernels::f32::price_risk_neutral_one_period", n);
+            FINCRAFTR_TRACE_SPAN("kernels::f32::price_risk_neutral_one_period", n);
+            apply_f32(n, out, &fc::options::price_risk_neutral_one_period<fc::math::fast>, S0, Su, Sd, Cu, Cd, r, tau);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+/// Minimal checks for the C++ tests, which run under ctest without a test framework
+///
+/// A failed check prints its location and expression and the test carries on, so one run
+/// reports every failure; main() returns fc::test::result() to fail the ctest entry.
+namespace fc::test {
+    inline int failures = 0;
+
+    inline void fail(const char* file, int line, const char* what) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+        ++failures;
+    }
+
+    /// @return True if a and b agree to within tol, absolutely or relative to the larger
+    inline bool close(double a, double b, double tol) {
+        return std::abs(a - b) <= tol * std::fmax(1.0, std::fmax(std::abs(a), std::abs(b)));
+    }
+
+    /// @return Exit status for main(): 0 if every check passed
+    inline int result() {
+        if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return failures ? 1 : 0;
+    }
+}
+
+#define FC_CHECK(cond) \
+    ((cond) ? void() : fc::test::fail(__FILE__, __LINE__, #cond))
+
+#define FC_CHECK_CLOSE(a, b, tol) \
+    (fc::test::close((a), (b), (tol)) ? void() : fc::test::fail(__FILE__, __LINE__, #a " ~= " #b))
+
+#define FC_CHECK_THROWS(expr, Exception)                                             \
+    do {                                                                             \
+        bool fc_thrown_ = false;                                                     \
+        try {                                                                        \
+            static_cast<void>(expr);                                                 \
+        } catch (const Exception&) {                                                 \
+            fc_thrown_ = true;                                                       \
+        }                                                                            \
+        if (!fc_thrown_) fc::test::fail(__FILE__, __LINE__, #expr " throws " #Exception); \
+    } while (false)
@@ -0,0 +1,246 @@
+// fc::async awaitables: results, cancellation and exceptions, and chunk streams destroyed
+// before they finish, including on the only worker of the pool (which used to deadlock)
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fincraftr/core/async.hpp>
+
+#include "check.hpp"
+
+namespace {
+    namespace fa = fc::async;
+
+    /// Coroutine that starts at once and frees itself when it returns
+    struct detached {
+        struct promise_type {
+            detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    /// Coroutine that starts at once and stays suspended until its handle is destroyed
+    struct owned {
+        struct promise_type {
+            owned get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /// Result channel of a coroutine; the promise lives in the coroutine frame, so setting it
+    /// is finished before the promise is freed
+    template <class T>
+    using promise_ptr = std::shared_ptr<std::promise<T>>;
+
+    template <class T>
+    std::pair<promise_ptr<T>, std::future<T>> channel() {
+        auto p = std::make_shared<std::promise<T>>();
+        auto f = p->get_future();
+        return {std::move(p), std::move(f)};
+    }
+
+    /// Wait for a coroutine's result; a deadlock fails the test instead of hanging ctest
+    template <class T>
+    T wait(std::future<T>& f, const char* what) {
+        if (f.wait_for(std::chrono::seconds(30)) != std::future_status::ready) {
+            std::fprintf(stderr, "deadlock: %s\n", what);
+            std::_Exit(1);
+        }
+        return f.get();
+    }
+
+    template <class Body>
+    detached drive(fa::executor& ex, std::size_t n, std::size_t grain, Body body, std::stop_token stop,
+                   promise_ptr<void> done) {
+        try {
+            co_await fa::parallel_for(ex, n, grain, std::move(body), std::move(stop));
+            done->set_value();
+        } catch (...) {
+            done->set_exception(std::current_exception());
+        }
+    }
+
+    /// Consume a whole stream, returning the ranges in the order they arrived
+    detached consume(fa::executor& ex, std::vector<double>& x, std::size_t grain,
+                     promise_ptr<std::vector<std::pair<std::size_t, std::size_t>>> done) {
+        try {
+            auto stream = fa::chunks(ex, x.size(), grain, [&x](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) x[i] += 1.0;
+            });
+            std::vector<std::pair<std::size_t, std::size_t>> ranges;
+            while (auto r = co_await stream.next()) ranges.push_back(*r);
+            done->set_value(std::move(ranges));
+        } catch (...) {
+            done->set_exception(std::current_exception());
+        }
+    }
+
+    /// Take one range and return, destroying the unfinished stream on an executor worker
+    detached abandon(fa::executor& ex, std::vector<double>& x, promise_ptr<void> done) {
+        {
+            auto stream = fa::chunks(ex, x.size(), 64, [&x](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) x[i] += 1.0;
+            });
+            co_await stream.next();
+        }
+        done->set_value();
+    }
+
+    template <class F>
+    detached run_on(fa::executor& ex, F f, std::stop_token stop, promise_ptr<double> done) {
+        try {
+            done->set_value(co_await fa::run(ex, std::move(f), std::move(stop)));
+        } catch (...) {
+            done->set_exception(std::current_exception());
+        }
+    }
+
+    bool cancelled(const std::system_error& e) { return e.code() == std::errc::operation_canceled; }
+}
+
+int main() {
+    fc::parallel::thread_pool one(1), four(4);
+    fa::executor single(one), wide(four);
+
+    for (fa::executor* ex : {&single, &wide}) {
+        // parallel_for covers [0, n) once
+        {
+            std::vector<double> x(10000, 0.0);
+            auto [done, f] = channel<void>();
+            drive(*ex, x.size(), 100, [&x](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) x[i] += static_cast<double>(i);
+            }, {}, done);
+            wait(f, "parallel_for");
+            bool all = true;
+            for (std::size_t i = 0; i < x.size(); ++i) all = all && x[i] == static_cast<double>(i);
+            FC_CHECK(all);
+        }
+
+        // A stop requested up front runs nothing and cancels the await
+        {
+            std::vector<double> x(1000, 0.0);
+            std::stop_source stop;
+            stop.request_stop();
+            auto [done, f] = channel<void>();
+            drive(*ex, x.size(), 10, [&x](std::size_t b, std::size_t e) {
+                for (std::size_t i = b; i < e; ++i) x[i] = 1.0;
+            }, stop.get_token(), done);
+            bool thrown = false;
+            try {
+                wait(f, "cancelled parallel_for");
+            } catch (const std::system_error& e) {
+                thrown = cancelled(e);
+            }
+            FC_CHECK(thrown);
+            bool untouched = true;
+            for (double v : x) untouched = untouched && v == 0.0;
+            FC_CHECK(untouched);
+        }
+
+        // The first exception of a chunk reaches the awaiting coroutine
+        {
+            auto [done, f] = channel<void>();
+            drive(*ex, 1000, 10, [](std::size_t b, std::size_t) {
+                if (b == 500) throw std::runtime_error("chunk failed");
+            }, {}, done);
+            FC_CHECK_THROWS(wait(f, "throwing parallel_for"), std::runtime_error);
+        }
+
+        // A stream delivers every range once, then std::nullopt
+        {
+            std::vector<double> x(5000, 0.0);
+            auto [done, f] = channel<std::vector<std::pair<std::size_t, std::size_t>>>();
+            consume(*ex, x, 128, done);
+            const auto ranges = wait(f, "chunk stream");
+            std::vector<int> seen(x.size(), 0);
+            for (auto [b, e] : ranges)
+                for (std::size_t i = b; i < e && i < seen.size(); ++i) ++seen[i];
+            bool once = true;
+            for (std::size_t i = 0; i < x.size(); ++i) once = once && seen[i] == 1 && x[i] == 1.0;
+            FC_CHECK(once);
+            FC_CHECK(ranges.size() == (x.size() + 127) / 128);
+        }
+
+        // A stream abandoned after one range, inside a coroutine resumed on a worker
+        for (int rep = 0; rep < 20; ++rep) {
+            std::vector<double> x(1 << 14, 0.0);
+            auto [done, f] = channel<void>();
+            abandon(*ex, x, done);
+            wait(f, "abandoned chunk stream");
+            bool bounded = true;
+            for (double v : x) bounded = bounded && (v == 0.0 || v == 1.0);
+            FC_CHECK(bounded);
+        }
+
+        // run() returns the result, passes the stop token on and skips f once stop is requested
+        {
+            auto [done, f] = channel<double>();
+            run_on(*ex, [] { return 42.0; }, {}, done);
+            FC_CHECK(wait(f, "run") == 42.0);
+
+            std::stop_source stop;
+            auto [polled, g] = channel<double>();
+            run_on(*ex, [](std::stop_token t) { return t.stop_possible() ? 1.0 : 0.0; }, stop.get_token(), polled);
+            FC_CHECK(wait(g, "run with stop token") == 1.0);
+
+            stop.request_stop();
+            auto [skipped, h] = channel<double>();
+            run_on(*ex, [] { return 1.0; }, stop.get_token(), skipped);
+            bool thrown = false;
+            try {
+                wait(h, "cancelled run");
+            } catch (const std::system_error& e) {
+                thrown = cancelled(e);
+            }
+            FC_CHECK(thrown);
+        }
+    }
+
+    // Deadlock reproducer: a task holds the only worker while a coroutine suspends in next()
+    // with its first chunk queued behind it, then destroys that coroutine (and with it the
+    // stream) on the worker. The stream's destructor must run the queued chunk itself.
+    {
+        std::vector<double> out(1 << 16, 0.0);
+        for (int rep = 0; rep < 100; ++rep) {
+            std::atomic<bool> go{false};
+            auto [destroyed, f] = channel<void>();
+            std::coroutine_handle<> victim;
+            single.post([&go, &victim, done = destroyed] {
+                while (!go.load()) std::this_thread::yield();
+                victim.destroy();
+                done->set_value();
+            });
+            auto co = [&]() -> owned {
+                auto stream = fa::chunks(single, out.size(), 256, [&out](std::size_t b, std::size_t e) {
+                    for (std::size_t i = b; i < e; ++i) out[i] += 1.0;
+                });
+                co_await stream.next();  // the chunk task is queued behind the blocker
+            };
+            victim = co().handle;
+            go = true;
+            wait(f, "chunk stream destroyed on the only worker");
+        }
+    }
+
+    return fc::test::result();
+}
@@ -0,0 +1,97 @@
+// brinson_fachler_batch equals a loop of brinson_fachler calls, whatever the thread count
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/equity/attribution.hpp>
+
+#include "check.hpp"
+
+namespace {
+    constexpr std::size_t sectors = 11;
+
+    /// Owns the columns an AttributionHoldings points into
+    struct portfolio {
+        std::vector<double> wp, wb, r;
+        std::vector<std::uint32_t> sector;
+
+        fc::equity::AttributionHoldings view() const { return {wp, wb, r, sector}; }
+    };
+
+    portfolio random_portfolio(std::mt19937_64& rng) {
+        std::uniform_int_distribution<std::size_t> size(1, 300);
+        std::uniform_int_distribution<std::uint32_t> pick_sector(0, sectors - 1);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        portfolio p;
+        const std::size_t n = size(rng);
+        double sp = 0.0, sb = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            // About a third of the securities are held by one side only
+            const double u = unit(rng);
+            p.wp.push_back(u < 0.15 ? 0.0 : unit(rng));
+            p.wb.push_back(u > 0.85 ? 0.0 : unit(rng));
+            p.r.push_back(0.2 * (unit(rng) - 0.4));
+            p.sector.push_back(pick_sector(rng));
+            sp += p.wp.back();
+            sb += p.wb.back();
+        }
+        if (sp == 0.0) sp = p.wp[0] = 1.0;
+        if (sb == 0.0) sb = p.wb[0] = 1.0;
+        for (double& w : p.wp) w /= sp;
+        for (double& w : p.wb) w /= sb;
+        return p;
+    }
+
+    bool same(const fc::equity::BrinsonAttribution& a, const fc::equity::BrinsonAttribution& b) {
+        return a.allocation == b.allocation && a.selection == b.selection && a.interaction == b.interaction
+            && a.total_allocation == b.total_allocation && a.total_selection == b.total_selection
+            && a.total_interaction == b.total_interaction && a.portfolio_return == b.portfolio_return
+            && a.benchmark_return == b.benchmark_return;
+    }
+}
+
+int main() {
+    // Two sectors by hand: Wp = (0.6, 0.4), Wb = (0.5, 0.5), Rp_s = (0.10, 0.02), Rb_s = (0.08, 0.03)
+    {
+        const std::vector<double> wp = {0.6, 0.0, 0.4, 0.0}, wb = {0.0, 0.5, 0.0, 0.5}, r = {0.10, 0.08, 0.02, 0.03};
+        const std::vector<std::uint32_t> sector = {0, 0, 1, 1};
+        const auto a = fc::equity::brinson_fachler({wp, wb, r, sector}, 2);
+        const double Rb = 0.055;
+        FC_CHECK_CLOSE(a.benchmark_return, Rb, 1e-15);
+        FC_CHECK_CLOSE(a.portfolio_return, 0.068, 1e-15);
+        FC_CHECK_CLOSE(a.allocation[0], 0.1 * (0.08 - Rb), 1e-15);
+        FC_CHECK_CLOSE(a.selection[1], 0.5 * (0.02 - 0.03), 1e-15);
+        FC_CHECK_CLOSE(a.interaction[0], 0.1 * (0.10 - 0.08), 1e-15);
+    }
+
+    std::mt19937_64 rng(79);
+    std::vector<portfolio> books;
+    for (int k = 0; k < 257; ++k) books.push_back(random_portfolio(rng));
+    std::vector<fc::equity::AttributionHoldings> views;
+    for (const portfolio& p : books) views.push_back(p.view());
+
+    std::vector<fc::equity::BrinsonAttribution> expected;
+    for (const auto& v : views) expected.push_back(fc::equity::brinson_fachler(v, sectors));
+
+    for (unsigned threads : {1u, 3u, 0u}) {
+        const auto batch = fc::equity::brinson_fachler_batch(views, sectors, threads);
+        FC_CHECK(batch.size() == expected.size());
+        for (std::size_t p = 0; p < batch.size() && p < expected.size(); ++p) FC_CHECK(same(batch[p], expected[p]));
+    }
+
+    // Effects reconcile to the active return when both weight columns sum to 1
+    for (const auto& a : expected) {
+        const double effects = a.total_allocation + a.total_selection + a.total_interaction;
+        FC_CHECK_CLOSE(effects, a.portfolio_return - a.benchmark_return, 1e-12);
+    }
+
+    FC_CHECK(fc::equity::brinson_fachler_batch({}, sectors).empty());
+    books[100].sector[0] = sectors;
+    views[100] = books[100].view();
+    FC_CHECK_THROWS(fc::equity::brinson_fachler_batch(views, sectors, 0), std::invalid_argument);
+
+    return fc::test::result();
+}
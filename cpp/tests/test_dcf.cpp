@@ -0,0 +1,86 @@
+// dcf_monte_carlo: fixed-seed results must not depend on the thread count
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/equity/dcf.hpp>
+
+#include "check.hpp"
+
+namespace {
+    std::vector<fc::equity::DcfCompany> companies() {
+        std::vector<fc::equity::DcfCompany> out;
+        for (int c = 0; c < 9; ++c) {
+            fc::equity::DcfCompany co;
+            co.revenue = 100.0 + 25.0 * c;
+            co.years = 3 + c % 5;
+            co.mean = {0.05 + 0.01 * c, 0.02, 0.15, 0.09};
+            // Wide terminal-growth and discount-rate spreads, so some scenarios are masked
+            co.vol = {0.03, 0.02, 0.04, 0.03};
+            out.push_back(co);
+        }
+        return out;
+    }
+
+    bool same(const std::vector<fc::equity::DcfDistribution>& a, const std::vector<fc::equity::DcfDistribution>& b) {
+        if (a.size() != b.size()) return false;
+        for (std::size_t c = 0; c < a.size(); ++c) {
+            if (a[c].valid != b[c].valid || a[c].masked != b[c].masked || a[c].mean != b[c].mean
+                || a[c].percentiles != b[c].percentiles)
+                return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    const auto cos = companies();
+    fc::equity::DcfMonteCarloConfig config;
+    config.scenarios = 4000;
+    config.percentiles = {95.0, 5.0, 50.0};
+    config.correlation = {1.0, 0.3, 0.0, 0.2,
+                          0.3, 1.0, 0.0, 0.4,
+                          0.0, 0.0, 1.0, 0.0,
+                          0.2, 0.4, 0.0, 1.0};
+    config.seed = 7;
+
+    config.threads = 1;
+    const auto serial = fc::equity::dcf_monte_carlo(cos, config);
+    FC_CHECK(serial.size() == cos.size());
+    for (unsigned threads : {2u, 3u, 8u, 0u}) {
+        config.threads = threads;
+        FC_CHECK(same(fc::equity::dcf_monte_carlo(cos, config), serial));
+    }
+
+    std::size_t masked = 0;
+    for (const auto& d : serial) {
+        FC_CHECK(d.valid + d.masked == config.scenarios);
+        // Reported in the order requested, not sorted
+        FC_CHECK(d.percentiles.size() == 3);
+        FC_CHECK(d.percentiles[1] <= d.percentiles[2] && d.percentiles[2] <= d.percentiles[0]);
+        masked += d.masked;
+    }
+    FC_CHECK(masked > 0);
+
+    config.threads = 1;
+    config.seed = 8;
+    FC_CHECK(!same(fc::equity::dcf_monte_carlo(cos, config), serial));
+
+    // Without volatility every scenario is the deterministic two-stage value
+    std::vector<fc::equity::DcfCompany> fixed = {cos[0]};
+    fixed[0].vol = {};
+    const auto flat = fc::equity::dcf_monte_carlo(fixed, config);
+    const double v = fc::equity::dcf_two_stage(fixed[0].revenue, fixed[0].mean.margin, fixed[0].mean.growth,
+                                               fixed[0].mean.terminal_growth, fixed[0].mean.discount_rate,
+                                               fixed[0].years);
+    FC_CHECK(flat[0].masked == 0);
+    FC_CHECK_CLOSE(flat[0].mean, v, 1e-12);
+    for (double p : flat[0].percentiles) FC_CHECK_CLOSE(p, v, 1e-12);
+
+    config.percentiles = {101.0};
+    FC_CHECK_THROWS(fc::equity::dcf_monte_carlo(cos, config), std::invalid_argument);
+
+    return fc::test::result();
+}
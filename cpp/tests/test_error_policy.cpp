@@ -0,0 +1,152 @@
+// Error policies: under the default policy every converted function throws exactly where
+// its pre-policy version threw and returns the same value (NaN included) everywhere else;
+// policy::nan and policy::status report the same inputs as errors
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/core/error.hpp>
+#include <fincraftr/equity/attribution.hpp>
+#include <fincraftr/equity/basic.hpp>
+#include <fincraftr/equity/dcf.hpp>
+#include <fincraftr/equity/returns.hpp>
+#include <fincraftr/equity/valuation.hpp>
+
+#include "check.hpp"
+
+namespace {
+    constexpr double qnan = std::numeric_limits<double>::quiet_NaN();
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    const std::vector<double> inputs = {1.5, -2.0, 0.0, -0.0, 0.05, 0.08, qnan, inf, -inf};
+
+    // The functions as they were before the error policies, throwing std::invalid_argument
+    double old_return_simple(double Pt, double Pt_prev) {
+        if (Pt_prev == 0.0) throw std::invalid_argument("Previous price must be nonzero");
+        return (Pt / Pt_prev) - 1.0;
+    }
+
+    double old_ownership_fraction(double shares_owned, double shares_outstanding) {
+        if (shares_outstanding <= 0.0) throw std::invalid_argument("shares_outstanding must be > 0");
+        return shares_owned / shares_outstanding;
+    }
+
+    double old_cost_of_equity(double D1, double S1, double S0) {
+        if (S0 == 0.0) throw std::invalid_argument("S0 must be nonzero");
+        return (D1 + S1) / S0 - 1.0;
+    }
+
+    double old_ddm_gordon_growth(double D1, double r, double g) {
+        if (g >= r) throw std::invalid_argument("g must be less than r");
+        return D1 / (r - g);
+    }
+
+    double old_dcf_two_stage(double revenue, double margin, double g, double g_terminal, double r, int years) {
+        const double cf_next = revenue * margin * std::pow(1.0 + g, years) * (1.0 + g_terminal);
+        const double terminal = old_ddm_gordon_growth(cf_next, r, g_terminal) / std::pow(1.0 + r, years);
+        const double q = (1.0 + g) / (1.0 + r);
+        const double annuity = (std::abs(1.0 - q) < 1e-12)
+            ? static_cast<double>(years)
+            : q * (1.0 - std::pow(q, years)) / (1.0 - q);
+        return revenue * margin * annuity + terminal;
+    }
+
+    template <class F>
+    std::optional<double> outcome(F f) {
+        try {
+            return f();
+        } catch (const std::invalid_argument&) {
+            return std::nullopt;
+        }
+    }
+
+    bool same_value(double a, double b, double tol) {
+        if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+        if (std::isinf(a) || std::isinf(b)) return a == b;
+        return tol == 0.0 ? a == b : fc::test::close(a, b, tol);
+    }
+
+    /// Compare old(args...) with New<policy>(args...) under all three policies
+    template <class Old, class New>
+    void compare(Old old_fn, New new_fn, double tol) {
+        const std::optional<double> expected = outcome(old_fn);
+        const std::optional<double> actual = outcome([&] { return new_fn(fc::policy::throwing{}); });
+        FC_CHECK(expected.has_value() == actual.has_value());
+        if (expected && actual) FC_CHECK(same_value(*expected, *actual, tol));
+
+        const double as_nan = new_fn(fc::policy::nan{});
+        const fc::result<double> as_status = new_fn(fc::policy::status{});
+        FC_CHECK(as_status.has_value() == expected.has_value());
+        if (expected) {
+            FC_CHECK(same_value(as_nan, *expected, tol));
+            if (as_status) FC_CHECK(same_value(as_status.value(), *expected, tol));
+        } else {
+            FC_CHECK(std::isnan(as_nan));
+            FC_CHECK(as_status.error() == fc::errc::invalid_argument);
+        }
+    }
+}
+
+int main() {
+    using namespace fc::equity;
+
+    for (double a : inputs) {
+        for (double b : inputs) {
+            compare([&] { return old_return_simple(a, b); },
+                    [&](auto p) { return return_simple<decltype(p)>(a, b); }, 0.0);
+            compare([&] { return old_ownership_fraction(a, b); },
+                    [&](auto p) { return ownership_fraction<decltype(p)>(a, b); }, 0.0);
+            for (double c : inputs) {
+                compare([&] { return old_cost_of_equity(a, b, c); },
+                        [&](auto p) { return cost_of_equity<decltype(p)>(a, b, c); }, 0.0);
+                compare([&] { return old_ddm_gordon_growth(a, b, c); },
+                        [&](auto p) { return ddm_gordon_growth<decltype(p)>(a, b, c); }, 0.0);
+            }
+        }
+    }
+
+    // dcf_two_stage was rearranged when it gained a policy, so values agree to rounding only
+    const std::vector<double> rates = {-0.5, 0.0, 0.02, 0.05, 0.09, 0.12, qnan};
+    for (double g : rates)
+        for (double g_terminal : rates)
+            for (double r : rates)
+                for (int years : {0, 1, 5}) {
+                    if (g == -0.5 && r == -0.5) continue;  // 0/0 growth ratio in either form
+                    compare([&] { return old_dcf_two_stage(120.0, 0.15, g, g_terminal, r, years); },
+                            [&](auto p) { return dcf_two_stage<decltype(p)>(120.0, 0.15, g, g_terminal, r, years); },
+                            1e-10);
+                }
+
+    // returns_simple throws on the first zero previous price, or fills NaN under policy::nan
+    {
+        const std::vector<double> Pt = {105.0, 99.0, qnan, 10.0}, prev = {100.0, 0.0, 50.0, -0.0};
+        std::vector<double> out(Pt.size());
+        FC_CHECK_THROWS(returns_simple(Pt, prev, out), std::invalid_argument);
+        returns_simple<fc::policy::nan>(Pt, prev, out);
+        FC_CHECK_CLOSE(out[0], 0.05, 1e-15);
+        FC_CHECK(std::isnan(out[1]) && std::isnan(out[2]) && std::isnan(out[3]));
+        const std::vector<double> ok_prev = {100.0, 90.0, 50.0, 8.0};
+        returns_simple(Pt, ok_prev, out);
+        FC_CHECK(std::isnan(out[2]));
+        FC_CHECK_CLOSE(out[3], 0.25, 1e-15);
+    }
+
+    // collect_errors reports the failing elements of a status kernel
+    {
+        const std::vector<double> prev = {100.0, 0.0, qnan, -0.0};
+        std::vector<double> out(prev.size());
+        std::vector<fc::errc> errors(prev.size());
+        const std::size_t failed = fc::collect_errors(
+            [&](std::size_t i) { return return_simple<fc::policy::status>(110.0, prev[i]); }, out, errors);
+        FC_CHECK(failed == 2);
+        FC_CHECK(errors[0] == fc::errc::ok && errors[1] == fc::errc::invalid_argument);
+        FC_CHECK(errors[2] == fc::errc::ok && std::isnan(out[2]));
+        FC_CHECK(errors[3] == fc::errc::invalid_argument && std::isnan(out[3]));
+    }
+
+    return fc::test::result();
+}
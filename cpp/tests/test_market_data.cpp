@@ -0,0 +1,121 @@
+// MarketDataStore under concurrent readers and writers: every guard sees one whole snapshot,
+// versions never go backwards for a reader, and epoch reclamation frees every retired
+// snapshot once the readers are gone. Meant to be run under -fsanitize=thread and address.
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fincraftr/core/market_data.hpp>
+
+#include "check.hpp"
+
+namespace {
+    using fc::market::market_data;
+    using fc::market::MarketDataStore;
+
+    constexpr int writers = 2;
+    constexpr int readers = 4;
+    constexpr int updates_per_writer = 2000;
+
+    /// Every field encodes the number of updates applied so far, which is the version
+    void bump(market_data& d) {
+        const double v = d.spots.at("A") + 1.0;
+        d.spots["A"] = v;
+        d.spots["B"] = -v;
+        d.curves["USD"] = fc::market::rate_curve({1.0, 2.0}, {v, 2.0 * v});
+        d.dividends["A"].push_back({v, 1.0});
+    }
+
+    /// @return True if the snapshot is whole: all fields agree with each other and the version
+    bool consistent(const MarketDataStore::guard& g) {
+        const double v = g->spot("A");
+        return v == static_cast<double>(g.version()) && g->spot("B") == -v && g->curve("USD").rate(1.5) == 1.5 * v
+            && g->dividends.at("A").size() == g.version();
+    }
+}
+
+int main() {
+    // Single-threaded: an open guard keeps its snapshot, and reclaim() frees it once closed
+    {
+        market_data m;
+        m.spots["A"] = 0.0;
+        m.spots["B"] = 0.0;
+        m.curves["USD"] = fc::market::rate_curve({1.0, 2.0}, {0.0, 0.0});
+        m.dividends["A"] = {};
+        MarketDataStore store(m, {.max_readers = 2});
+        auto r = store.make_reader();
+        {
+            auto g = r.read();
+            FC_CHECK(store.update(bump) == 1 && store.update(bump) == 2);
+            FC_CHECK(g.version() == 0 && g->spot("A") == 0.0);
+            FC_CHECK(store.reclaim() == 2);
+            FC_CHECK_THROWS(r.read(), std::logic_error);
+        }
+        FC_CHECK(store.reclaim() == 0);
+        auto g = r.read();
+        FC_CHECK(g.version() == 2 && consistent(g));
+        auto other = store.make_reader();
+        FC_CHECK_THROWS(store.make_reader(), std::length_error);
+    }
+
+    // Readers churn through guards and handles while writers publish and reclaim
+    market_data m;
+    m.spots["A"] = 0.0;
+    m.spots["B"] = 0.0;
+    m.curves["USD"] = fc::market::rate_curve({1.0, 2.0}, {0.0, 0.0});
+    m.dividends["A"] = {};
+    MarketDataStore store(m, {.max_readers = readers + 1});
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0}, backwards{0};
+    std::atomic<std::uint64_t> reads{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                // A fresh handle every so often, so slots are released and reclaimed concurrently
+                auto r = store.make_reader();
+                std::uint64_t last = 0;
+                for (int k = 0; k < 200 && !stop.load(std::memory_order_relaxed); ++k, ++n) {
+                    auto g = r.read();
+                    if (!consistent(g)) ++torn;
+                    if (g.version() < last) ++backwards;
+                    last = g.version();
+                    // Some guards stay open across several publishes
+                    if ((n + static_cast<std::uint64_t>(t)) % 64 == 0) std::this_thread::yield();
+                }
+            }
+            reads += n;
+        });
+    }
+
+    std::vector<std::thread> writer_threads;
+    for (int w = 0; w < writers; ++w) {
+        writer_threads.emplace_back([&, w] {
+            for (int i = 0; i < updates_per_writer; ++i) {
+                store.update(bump);
+                if ((i + w) % 100 == 0) store.reclaim();
+            }
+        });
+    }
+    for (auto& t : writer_threads) t.join();
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    FC_CHECK(torn == 0);
+    FC_CHECK(backwards == 0);
+    FC_CHECK(reads > 0);
+    FC_CHECK(store.version() == static_cast<std::uint64_t>(writers) * updates_per_writer);
+    FC_CHECK(store.reclaim() == 0);
+    auto r = store.make_reader();
+    auto g = r.read();
+    FC_CHECK(consistent(g) && g.version() == store.version());
+
+    return fc::test::result();
+}
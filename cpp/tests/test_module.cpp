@@ -0,0 +1,69 @@
+// Consumer of the fincraftr named module: uses names from every partition through
+// import fincraftr; alone. Built only with -DFINCRAFTR_BUILD_MODULE=ON.
+//
+// Nothing is #included, so the library and the standard library reach this file only
+// through the module; check.hpp is not used for the same reason.
+
+import fincraftr;
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok) {
+        if (!ok) ++failures;
+    }
+
+    bool close(double a, double b) {
+        const double d = a - b;
+        return d < 1e-12 && d > -1e-12;
+    }
+}
+
+int main() {
+    // :core
+    check(close(fc::math::exp(0.0), 1.0));
+    check(fc::parallel::default_threads() >= 1);
+    double sum = 0.0;
+    fc::parallel::parallel_for(100, 10, 1, [&](unsigned long b, unsigned long e) {
+        for (unsigned long i = b; i < e; ++i) sum += static_cast<double>(i);
+    });
+    check(sum == 4950.0);
+    const double undefined = fc::equity::return_simple<fc::policy::nan>(1.0, 0.0);
+    check(undefined != undefined);
+    check(fc::equity::return_simple<fc::policy::status>(1.0, 0.0).error() == fc::errc::invalid_argument);
+
+    fc::graph::ValuationGraph g;
+    const fc::graph::node_id S = g.add_input(100.0, "S"), r = g.add_input(0.05, "r"), tau = g.add_input(1.0, "tau");
+    const fc::graph::node_id F = g.add(&fc::forwards::forward_price_no_div<>, {S, r, tau}, "forward");
+    check(close(g.value(F), fc::forwards::forward_price_no_div(100.0, 0.05, 1.0)));
+
+    fc::market::MarketDataStore store;
+    store.update([](fc::market::market_data& m) { m.curves["USD"] = fc::market::rate_curve(0.03); });
+    auto reader = store.make_reader();
+    check(reader.read()->curve("USD").rate(2.0) == 0.03);
+
+    // :equity
+    check(close(fc::equity::market_cap(1000.0, 25.0), 25000.0));
+    check(close(fc::equity::return_simple(105.0, 100.0), 0.05));
+
+    // :options
+    check(fc::options::payoff_call(105.0, 100.0) == 5.0);
+    check(fc::options::payoff_put(105.0, 100.0) == 0.0);
+
+    // :forwards
+    check(close(fc::forwards::forward_price_no_div(100.0, 0.0, 1.0), 100.0));
+
+    // :rates
+    check(close(fc::rates::roll_back_cont(fc::rates::compound_continuous(100.0, 0.05, 2.0), 0.05, 2.0), 100.0));
+
+#if defined(FINCRAFTR_MODULE_KERNELS)
+    // Out-of-line kernels, exported when the module is built over the compiled library
+    const double spot[2] = {100.0, 50.0}, rate[2] = {0.0, 0.0}, t[2] = {1.0, 1.0};
+    double fwd[2] = {0.0, 0.0};
+    fc::kernels::forward_price_no_div(2, spot, rate, t, fwd);
+    check(fwd[0] == 100.0 && fwd[1] == 50.0);
+    check(fc::kernels::isa() != nullptr);
+#endif
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+// OwnershipGraph::look_through against a plain Neumann-series reference, on both the push
+// (sparse frontier) and the pull (dense, parallel) paths
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/equity/ownership.hpp>
+
+#include "check.hpp"
+
+namespace {
+    using fc::equity::Shareholding;
+
+    /// x = a_t + A a_t + A^2 a_t + ... straight from the edge list
+    std::vector<double> reference(std::size_t n, const std::vector<Shareholding>& holdings, std::uint32_t target) {
+        std::vector<double> x(n, 0.0), d(n, 0.0), next(n, 0.0);
+        for (const Shareholding& h : holdings)
+            if (h.investee == target) d[h.holder] += h.shares_owned / h.shares_outstanding;
+        for (int it = 0; it < 10000; ++it) {
+            double largest = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] += d[i];
+                largest = std::max(largest, std::abs(d[i]));
+            }
+            if (largest < 1e-15) break;
+            std::fill(next.begin(), next.end(), 0.0);
+            for (const Shareholding& h : holdings) next[h.holder] += h.shares_owned / h.shares_outstanding * d[h.investee];
+            d.swap(next);
+        }
+        return x;
+    }
+
+    void check_matches(const fc::equity::LookThroughResult& r, const std::vector<double>& expected, double tol) {
+        FC_CHECK(r.converged);
+        FC_CHECK(r.ownership.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size() && i < r.ownership.size(); ++i)
+            FC_CHECK_CLOSE(r.ownership[i], expected[i], tol);
+    }
+
+    /// Random graph in which every investee's holders own at most 90% of it
+    std::vector<Shareholding> random_graph(std::size_t n, std::size_t holders_per_investee, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(n - 1));
+        std::uniform_real_distribution<double> stake(0.0, 0.9 / static_cast<double>(holders_per_investee));
+        std::vector<Shareholding> out;
+        for (std::uint32_t j = 0; j < n; ++j)
+            for (std::size_t k = 0; k < holders_per_investee; ++k)
+                out.push_back({pick(rng), j, 100.0 * stake(rng), 100.0});
+        return out;
+    }
+}
+
+int main() {
+    // Duplicate stakes are summed once, including a zero stake followed by a positive one
+    {
+        const fc::equity::OwnershipGraph zero_first(2, {{1, 0, 0.0, 100.0}, {1, 0, 30.0, 100.0}});
+        FC_CHECK_CLOSE(zero_first.look_through(0).ownership[1], 0.3, 1e-15);
+        FC_CHECK_CLOSE(zero_first.direct_stake(1, 0), 0.3, 1e-15);
+        const fc::equity::OwnershipGraph split(2, {{1, 0, 10.0, 100.0}, {1, 0, 20.0, 100.0}});
+        FC_CHECK_CLOSE(split.look_through(0).ownership[1], 0.3, 1e-15);
+    }
+
+    // Chain and cycle: 2 owns 50% of 1, 1 owns 40% of 0, and 0 owns 10% of 2
+    {
+        const std::vector<Shareholding> h = {{2, 1, 50.0, 100.0}, {1, 0, 40.0, 100.0}, {0, 2, 10.0, 100.0}};
+        const fc::equity::OwnershipGraph g(3, h);
+        const auto r = g.look_through(0);
+        check_matches(r, reference(3, h, 0), 1e-12);
+        // x1 = 0.4 + 0.4 * x0, x0 = 0.1 * x2, x2 = 0.5 * x1
+        FC_CHECK_CLOSE(r.ownership[1], 0.4 / (1.0 - 0.4 * 0.5 * 0.1), 1e-12);
+    }
+
+    // Small random graph: push path only
+    {
+        const std::size_t n = 60;
+        const auto h = random_graph(n, 3, 1);
+        const fc::equity::OwnershipGraph g(n, h);
+        for (std::uint32_t t : {0u, 17u, 59u}) check_matches(g.look_through(t), reference(n, h, t), 1e-10);
+    }
+
+    // Target held directly by 2000 entities: the frontier exceeds the dense threshold at once,
+    // so the parallel pull path runs; results must not depend on the thread count
+    {
+        const std::size_t n = 6000;
+        auto h = random_graph(n, 2, 2);
+        h.erase(std::remove_if(h.begin(), h.end(), [](const Shareholding& s) { return s.investee == 0; }), h.end());
+        for (std::uint32_t i = 1; i <= 2000; ++i) h.push_back({i, 0, 0.04, 100.0});
+        const fc::equity::OwnershipGraph g(n, h);
+        const auto expected = reference(n, h, 0);
+        fc::equity::LookThroughOptions options;
+        options.threads = 1;
+        const auto serial = g.look_through(0, options);
+        check_matches(serial, expected, 1e-10);
+        options.threads = 0;
+        const auto parallel = g.look_through(0, options);
+        check_matches(parallel, expected, 1e-10);
+        FC_CHECK(parallel.ownership == serial.ownership);
+
+        const auto batch = g.look_through(std::vector<std::uint32_t>{0, 5, 0}, options);
+        FC_CHECK(batch.size() == 3);
+        FC_CHECK(batch[0].ownership == serial.ownership && batch[2].ownership == serial.ownership);
+        check_matches(batch[1], reference(n, h, 5), 1e-10);
+    }
+
+    FC_CHECK_THROWS(fc::equity::OwnershipGraph(2, {{1, 0, 60.0, 100.0}, {0, 0, 50.0, 100.0}}), std::invalid_argument);
+    FC_CHECK_THROWS(fc::equity::OwnershipGraph(2, {{2, 0, 1.0, 100.0}}), std::invalid_argument);
+    FC_CHECK_THROWS(fc::equity::OwnershipGraph(2, {}).look_through(2), std::invalid_argument);
+
+    return fc::test::result();
+}
@@ -0,0 +1,189 @@
+// fc::parallel on a shared pool configured with one worker: configure() before and after
+// the pool starts, nested parallel_for (which must neither deadlock nor add threads),
+// wait_until() on workers waiting for each other, and exceptions thrown by loop bodies at
+// either level
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <fincraftr/core/parallel.hpp>
+
+#include "check.hpp"
+
+namespace {
+    namespace fp = fc::parallel;
+
+    /// Ends the process with a failure if the checks have not finished in time
+    std::jthread watchdog(std::chrono::seconds limit) {
+        return std::jthread([limit](std::stop_token stop) {
+            std::mutex m;
+            std::condition_variable_any cv;
+            std::unique_lock<std::mutex> lock(m);
+            if (!cv.wait_for(lock, stop, limit, [&] { return stop.stop_requested(); })) {
+                std::fprintf(stderr, "deadlock: parallel checks did not finish within %llds\n",
+                             static_cast<long long>(limit.count()));
+                std::_Exit(1);
+            }
+        });
+    }
+
+    /// Sum of i over [0, n) computed by a parallel_for nested in each item of an outer one
+    double nested_sum(std::size_t outer, std::size_t inner, std::mutex& m, std::set<std::thread::id>& threads) {
+        std::vector<double> partial(outer, 0.0);
+        fp::parallel_for(outer, 1, 4, [&](std::size_t b, std::size_t e) {
+            for (std::size_t o = b; o < e; ++o) {
+                std::vector<double> row(inner, 0.0);
+                fp::parallel_for(inner, 16, 4, [&](std::size_t ib, std::size_t ie) {
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        threads.insert(std::this_thread::get_id());
+                    }
+                    for (std::size_t i = ib; i < ie; ++i) row[i] = static_cast<double>(o * inner + i);
+                });
+                for (double v : row) partial[o] += v;
+            }
+        });
+        double total = 0.0;
+        for (double v : partial) total += v;
+        return total;
+    }
+}
+
+int main() {
+    std::jthread guard = watchdog(std::chrono::seconds(60));
+
+    // configure() applies until the shared pool starts and is rejected afterwards
+    fp::thread_pool::configure({.workers = 3});
+    fp::thread_pool::configure({.workers = 1});
+    fp::thread_pool& pool = fp::thread_pool::instance();
+    FC_CHECK(pool.size() == 1);
+    FC_CHECK(&fp::thread_pool::instance() == &pool);
+    FC_CHECK_THROWS(fp::thread_pool::configure({.workers = 2}), std::logic_error);
+    FC_CHECK(!pool.on_worker());
+
+    // Nested loops on the caller plus one worker use exactly those two threads
+    {
+        std::mutex m;
+        std::set<std::thread::id> threads;
+        const std::size_t outer = 16, inner = 1000;
+        const double n = static_cast<double>(outer * inner);
+        for (int rep = 0; rep < 50; ++rep) FC_CHECK(nested_sum(outer, inner, m, threads) == n * (n - 1.0) / 2.0);
+        FC_CHECK(threads.size() <= 2);
+        FC_CHECK(threads.count(std::this_thread::get_id()) == 1);
+    }
+
+    // Nested loops started from a task on the only worker, with no caller thread to help
+    {
+        std::atomic<bool> done{false};
+        std::atomic<bool> on_worker{false};
+        double sum = 0.0;
+        pool.submit([&] {
+            on_worker = pool.on_worker();
+            std::mutex m;
+            std::set<std::thread::id> threads;
+            sum = nested_sum(8, 500, m, threads);
+            done = true;
+        });
+        while (!done) std::this_thread::yield();
+        const double n = 8.0 * 500.0;
+        FC_CHECK(on_worker);
+        FC_CHECK(sum == n * (n - 1.0) / 2.0);
+    }
+
+    // Workers that wait on their own queued subtasks run them instead of blocking: with both
+    // workers of a pool waiting at once, a blocking wait would never return
+    {
+        fp::thread_pool two(2);
+        std::atomic<int> started{0}, finished{0}, inner{0};
+        for (int k = 0; k < 2; ++k) {
+            two.submit([&] {
+                ++started;
+                while (started.load() < 2) std::this_thread::yield();
+                std::atomic<int> pending{4};
+                for (int j = 0; j < 4; ++j) two.submit([&pending, &inner] { ++inner; --pending; });
+                two.wait_until([&] { return pending.load() == 0; });
+                ++finished;
+            });
+        }
+        while (finished.load() != 2) std::this_thread::yield();
+        FC_CHECK(inner == 8);
+    }
+
+    // The first exception of a body is rethrown by the caller, from either nesting level
+    {
+        std::atomic<std::size_t> calls{0};
+        FC_CHECK_THROWS(fp::parallel_for(1000, 10, 4, [&](std::size_t b, std::size_t) {
+            ++calls;
+            if (b == 300) throw std::runtime_error("outer body failed");
+        }), std::runtime_error);
+        FC_CHECK(calls <= 100);
+
+        FC_CHECK_THROWS(fp::parallel_for(8, 1, 4, [](std::size_t b, std::size_t) {
+            fp::parallel_for(100, 10, 4, [b](std::size_t ib, std::size_t) {
+                if (b == 5 && ib == 50) throw std::out_of_range("inner body failed");
+            });
+        }), std::out_of_range);
+
+        // A worker rethrows too when its loop runs as a pool task
+        std::atomic<bool> done{false}, caught{false};
+        pool.submit([&] {
+            try {
+                fp::parallel_for(100, 1, 4, [](std::size_t b, std::size_t) {
+                    if (b == 99) throw std::runtime_error("failed on the worker");
+                });
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            done = true;
+        });
+        while (!done) std::this_thread::yield();
+        FC_CHECK(caught);
+
+        // The pool is still usable afterwards
+        std::vector<int> hits(1000, 0);
+        fp::parallel_for(hits.size(), 7, 4, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) ++hits[i];
+        });
+        bool once = true;
+        for (int h : hits) once = once && h == 1;
+        FC_CHECK(once);
+    }
+
+    // Edge cases: nothing to do, grain 0, a single thread running inline
+    {
+        bool called = false;
+        fp::parallel_for(0, 1, 4, [&](std::size_t, std::size_t) { called = true; });
+        FC_CHECK(!called);
+        std::size_t items = 0;
+        fp::parallel_for(5, 0, 1, [&](std::size_t b, std::size_t e) {
+            FC_CHECK(e == b + 1);
+            items += e - b;
+        });
+        FC_CHECK(items == 5);
+    }
+
+    // A private pool with pinned workers (best effort) runs every submitted task
+    {
+        std::atomic<int> ran{0};
+        {
+            fp::thread_pool pinned(fp::pool_options{.workers = 2, .pin = true, .cpus = {0}});
+            FC_CHECK(pinned.size() == 2);
+            for (int k = 0; k < 1000; ++k) pinned.submit([&ran] { ++ran; });
+            while (ran.load() != 1000) std::this_thread::yield();
+        }
+        FC_CHECK(ran == 1000);
+    }
+
+    guard.request_stop();
+    return fc::test::result();
+}
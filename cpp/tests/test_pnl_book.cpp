@@ -0,0 +1,105 @@
+// PnlBook: after any sequence of ticks the aggregates equal the sums of the lot P&L, and
+// resync() leaves them where the incremental updates put them
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/equity/pnl_book.hpp>
+
+#include "check.hpp"
+
+namespace {
+    constexpr std::size_t instruments = 12;  // instrument 11 holds no lots
+    constexpr std::size_t desks = 5;
+
+    struct sums {
+        double firm = 0.0;
+        std::vector<double> instrument = std::vector<double>(instruments, 0.0);
+        std::vector<double> desk = std::vector<double>(desks, 0.0);
+    };
+
+    sums sum_lots(const fc::equity::PnlBook& book, const std::vector<fc::equity::PnlLot>& lots) {
+        sums s;
+        for (std::size_t k = 0; k < lots.size(); ++k) {
+            const double v = book.lot_pnl(k);
+            s.firm += v;
+            s.instrument[lots[k].instrument] += v;
+            s.desk[lots[k].desk] += v;
+        }
+        return s;
+    }
+
+    void check_aggregates(const fc::equity::PnlBook& book, const sums& s, double tol) {
+        FC_CHECK_CLOSE(book.firm_pnl(), s.firm, tol);
+        for (std::uint32_t i = 0; i < instruments; ++i) FC_CHECK_CLOSE(book.instrument_pnl(i), s.instrument[i], tol);
+        for (std::uint32_t d = 0; d < desks; ++d) FC_CHECK_CLOSE(book.desk_pnl(d), s.desk[d], tol);
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<std::uint32_t> pick_instrument(0, instruments - 2);
+    std::uniform_int_distribution<std::uint32_t> pick_desk(0, desks - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<fc::equity::PnlLot> lots;
+    for (int k = 0; k < 400; ++k) {
+        fc::equity::PnlLot lot;
+        lot.instrument = pick_instrument(rng);
+        lot.desk = pick_desk(rng);
+        lot.quantity = (unit(rng) - 0.3) * 1000.0;
+        lot.S0 = 50.0 + 100.0 * unit(rng);
+        lot.r = 0.05 * unit(rng);
+        lot.tau = unit(rng);
+        lot.D_tau = unit(rng);
+        lot.C0 = 0.1 * unit(rng);
+        lots.push_back(lot);
+    }
+
+    fc::equity::PnlBook book(lots, instruments, desks);
+    FC_CHECK(book.size() == lots.size());
+    check_aggregates(book, sum_lots(book, lots), 1e-12);
+
+    std::vector<double> last(instruments, 0.0);
+    std::vector<bool> ticked(instruments, false);
+    for (int tick = 0; tick < 20000; ++tick) {
+        const std::uint32_t i = pick_instrument(rng);
+        const double price = 50.0 + 100.0 * unit(rng);
+        const double before = book.firm_pnl();
+        const double delta = book.on_tick(i, price);
+        FC_CHECK_CLOSE(book.firm_pnl() - before, delta, 1e-9);
+        last[i] = price;
+        ticked[i] = true;
+        if (tick % 5000 == 4999) check_aggregates(book, sum_lots(book, lots), 1e-9);
+    }
+    FC_CHECK(book.on_tick(instruments - 1, 10.0) == 0.0);
+
+    // Each lot is marked at its instrument's last price (or its entry price if never ticked)
+    for (std::size_t k = 0; k < lots.size(); ++k) {
+        const fc::equity::PnlLot& lot = lots[k];
+        const double mark = ticked[lot.instrument] ? last[lot.instrument] : lot.S0;
+        const double expected = lot.quantity * fc::equity::profit_with_costs(lot.S0, mark, lot.r, lot.tau,
+                                                                             lot.D_tau, lot.C0);
+        FC_CHECK_CLOSE(book.lot_pnl(k), expected, 1e-12);
+    }
+
+    const sums incremental = sum_lots(book, lots);
+    const double firm = book.firm_pnl();
+    std::vector<double> instrument(instruments), desk(desks);
+    for (std::uint32_t i = 0; i < instruments; ++i) instrument[i] = book.instrument_pnl(i);
+    for (std::uint32_t d = 0; d < desks; ++d) desk[d] = book.desk_pnl(d);
+
+    book.resync();
+    check_aggregates(book, incremental, 1e-12);
+    FC_CHECK_CLOSE(book.firm_pnl(), firm, 1e-9);
+    for (std::uint32_t i = 0; i < instruments; ++i) FC_CHECK_CLOSE(book.instrument_pnl(i), instrument[i], 1e-9);
+    for (std::uint32_t d = 0; d < desks; ++d) FC_CHECK_CLOSE(book.desk_pnl(d), desk[d], 1e-9);
+
+    FC_CHECK_THROWS(book.on_tick(instruments, 1.0), std::invalid_argument);
+    FC_CHECK_THROWS(fc::equity::PnlBook(lots, instruments, desks - 1), std::invalid_argument);
+
+    return fc::test::result();
+}
@@ -0,0 +1,177 @@
+// ValuationGraph: set() marks exactly the dependents dirty, value() evaluates only dirty
+// ancestors, parallel recompute() matches serial, and a throwing node stays dirty
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fincraftr/core/valuation_graph.hpp>
+#include <fincraftr/forwards/pricing.hpp>
+#include <fincraftr/options/payoff.hpp>
+#include <fincraftr/rates/discount.hpp>
+
+#include "check.hpp"
+
+namespace {
+    using fc::graph::node_id;
+    using fc::graph::ValuationGraph;
+
+    /// Sum of the inputs plus a constant, counting its own calls
+    ValuationGraph::function counted(std::atomic<int>& calls, double c = 0.0) {
+        return [&calls, c](std::span<const double> x) {
+            ++calls;
+            double s = c;
+            for (double v : x) s += v;
+            return s;
+        };
+    }
+
+    /// Inputs feeding three levels of computed nodes, each level wider than one task's grain
+    struct wide_graph {
+        ValuationGraph g;
+        std::vector<node_id> inputs, nodes;
+
+        explicit wide_graph(std::uint64_t seed) {
+            std::mt19937_64 rng(seed);
+            for (int i = 0; i < 300; ++i) inputs.push_back(g.add_input(0.01 * i));
+            std::vector<node_id> below = inputs;
+            for (int level = 0; level < 3; ++level) {
+                std::uniform_int_distribution<std::size_t> pick(0, below.size() - 1);
+                std::vector<node_id> here;
+                for (int k = 0; k < 400; ++k) {
+                    const node_id a = below[pick(rng)], b = below[pick(rng)];
+                    here.push_back(g.add_node({a, b}, [](std::span<const double> x) {
+                        return std::sin(x[0]) * 0.7 + std::sqrt(1.0 + x[1] * x[1]);
+                    }));
+                }
+                nodes.insert(nodes.end(), here.begin(), here.end());
+                below = std::move(here);
+            }
+        }
+    };
+}
+
+int main() {
+    // Dirty propagation: S -> F -> {P, Q}, and an unrelated U -> X
+    {
+        std::atomic<int> f_calls{0}, p_calls{0}, q_calls{0}, x_calls{0};
+        ValuationGraph g;
+        const node_id S = g.add_input(100.0, "S"), U = g.add_input(1.0, "U");
+        const node_id F = g.add_node({S}, counted(f_calls, 1.0), "F");
+        const node_id P = g.add_node({F}, counted(p_calls), "P");
+        const node_id Q = g.add_node({F, U}, counted(q_calls), "Q");
+        const node_id X = g.add_node({U}, counted(x_calls), "X");
+
+        for (node_id id : {F, P, Q, X}) FC_CHECK(g.dirty(id));
+        FC_CHECK(g.recompute() == 4);
+        for (node_id id : {S, U, F, P, Q, X}) FC_CHECK(!g.dirty(id));
+        FC_CHECK(g.recompute() == 0);
+
+        g.set(S, 100.0);  // unchanged value marks nothing
+        FC_CHECK(!g.dirty(F));
+        g.set(S, 101.0);
+        FC_CHECK(g.dirty(F) && g.dirty(P) && g.dirty(Q));
+        FC_CHECK(!g.dirty(S) && !g.dirty(U) && !g.dirty(X));
+
+        // value(P) evaluates F and P, leaving the other dirty node alone
+        const std::uint64_t before = g.evaluations();
+        FC_CHECK(g.value(P) == 102.0);
+        FC_CHECK(g.evaluations() - before == 2);
+        FC_CHECK(f_calls == 2 && p_calls == 2 && q_calls == 1 && x_calls == 1);
+        FC_CHECK(!g.dirty(F) && !g.dirty(P) && g.dirty(Q));
+        FC_CHECK(g.value(P) == 102.0 && g.evaluations() - before == 2);
+
+        // recompute() picks up only what value() left behind
+        FC_CHECK(g.recompute() == 1);
+        FC_CHECK(q_calls == 2 && g.value(Q) == 103.0);
+
+        g.set(U, 2.0);
+        FC_CHECK(g.dirty(Q) && g.dirty(X) && !g.dirty(F) && !g.dirty(P));
+        FC_CHECK(g.recompute() == 2);
+        FC_CHECK(f_calls == 2 && p_calls == 2 && q_calls == 3 && x_calls == 2);
+
+        FC_CHECK_THROWS(g.set(F, 1.0), std::invalid_argument);
+        FC_CHECK_THROWS(g.value(99), std::invalid_argument);
+        FC_CHECK_THROWS(g.add_node({S}, {}), std::invalid_argument);
+        FC_CHECK_THROWS(g.add_node({S, 99}, counted(f_calls)), std::invalid_argument);
+    }
+
+    // Library functions of fixed arity, as in the README example
+    {
+        ValuationGraph g;
+        const node_id S = g.add_input(100.0, "S"), r = g.add_input(0.05, "r");
+        const node_id q = g.add_input(0.02, "q"), tau = g.add_input(1.0, "tau"), K = g.add_input(95.0, "K");
+        const node_id F = g.add(&fc::forwards::forward_price_cont_yield<>, {S, r, q, tau}, "forward");
+        const node_id pv = g.add(&fc::rates::roll_back_cont<>, {g.add(&fc::options::payoff_call, {F, K}), r, tau}, "pv");
+        g.recompute();
+        g.set(r, 0.051);
+        const std::uint64_t before = g.evaluations();
+        const double expected = fc::rates::roll_back_cont(
+            fc::options::payoff_call(fc::forwards::forward_price_cont_yield(100.0, 0.051, 0.02, 1.0), 95.0), 0.051, 1.0);
+        FC_CHECK(g.value(pv) == expected);
+        FC_CHECK(g.evaluations() - before == 3);
+    }
+
+    // Parallel recompute() matches serial, after a full build and after scattered moves
+    {
+        wide_graph serial(5), parallel(5);
+        FC_CHECK(serial.g.recompute(1) == serial.nodes.size());
+        FC_CHECK(parallel.g.recompute(0) == parallel.nodes.size());
+        std::mt19937_64 rng(6);
+        std::uniform_int_distribution<std::size_t> pick(0, serial.inputs.size() - 1);
+        std::uniform_real_distribution<double> move(-1.0, 1.0);
+        for (int round = 0; round < 5; ++round) {
+            for (node_id id : serial.nodes) FC_CHECK(serial.g.value(id) == parallel.g.value(id));
+            for (int k = 0; k < 40; ++k) {
+                const std::size_t i = pick(rng);
+                const double v = move(rng);
+                serial.g.set(serial.inputs[i], v);
+                parallel.g.set(parallel.inputs[i], v);
+            }
+            const std::size_t evaluated = serial.g.recompute(1);
+            FC_CHECK(parallel.g.recompute(4) == evaluated);
+            FC_CHECK(evaluated < serial.nodes.size());
+        }
+        FC_CHECK(serial.g.evaluations() == parallel.g.evaluations());
+    }
+
+    // A throwing node and its dependents stay dirty, earlier levels keep their results, and
+    // the failed nodes are evaluated once the input is fixed
+    {
+        std::atomic<int> calls{0};
+        ValuationGraph g;
+        const node_id x = g.add_input(4.0, "x"), y = g.add_input(1.0, "y");
+        const node_id shifted = g.add_node({x}, counted(calls, 0.0), "shifted");
+        const node_id root = g.add_node({shifted}, [](std::span<const double> v) {
+            if (v[0] < 0.0) throw std::domain_error("negative input");
+            return std::sqrt(v[0]);
+        }, "root");
+        const node_id twice = g.add_node({root, root}, counted(calls, 0.0), "twice");
+        const node_id side = g.add_node({y}, counted(calls, 1.0), "side");
+        FC_CHECK(g.recompute() == 4);
+        FC_CHECK(g.value(twice) == 4.0);
+
+        g.set(x, -1.0);
+        FC_CHECK_THROWS(g.value(twice), std::domain_error);
+        FC_CHECK(!g.dirty(shifted) && g.dirty(root) && g.dirty(twice));
+
+        g.set(x, -4.0);
+        g.set(y, 2.0);
+        FC_CHECK_THROWS(g.recompute(), std::domain_error);
+        FC_CHECK(!g.dirty(shifted) && !g.dirty(side) && g.dirty(root) && g.dirty(twice));
+        FC_CHECK(g.value(side) == 3.0);
+        FC_CHECK_THROWS(g.recompute(), std::domain_error);
+
+        g.set(x, 9.0);
+        FC_CHECK(g.recompute() == 3);
+        FC_CHECK(!g.dirty(root) && !g.dirty(twice));
+        FC_CHECK(g.value(twice) == 6.0);
+    }
+
+    return fc::test::result();
+}
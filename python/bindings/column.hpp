@@ -0,0 +1,145 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#include <fincraftr/core/validity.hpp>
+
+// Arrow C Data Interface structures, as specified at
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace fcpy {
+    namespace py = pybind11;
+
+    /// Read-only float64 column borrowed from a Python object without copying
+    ///
+    /// Accepted inputs, in order of preference:
+    ///   - Arrow arrays exposing __arrow_c_array__ (PyCapsule interface) or _export_to_c
+    ///     (older pyarrow); chunked arrays are combined first. The validity bitmap is kept
+    ///     as a missing-value mask.
+    ///   - Any object supporting the buffer protocol with a contiguous 1-D float64 layout
+    ///     (NumPy arrays, memoryview, array.array('d'), ...).
+    ///   - Anything else NumPy can turn into a float64 array (lists, pandas Series, other
+    ///     dtypes); this path copies only when NumPy has to.
+    /// The column keeps its source alive; destroy it while holding the GIL.
+    class column {
+    public:
+        static column from(py::handle obj) {
+            column c;
+            if (py::hasattr(obj, "combine_chunks") && py::hasattr(obj, "num_chunks"))
+                return from(obj.attr("combine_chunks")());
+            if (py::hasattr(obj, "__arrow_c_array__")) {
+                c.load_arrow_capsules(obj);
+                return c;
+            }
+            if (py::hasattr(obj, "_export_to_c") && py::hasattr(obj, "type")) {
+                c.load_arrow_export(obj);
+                return c;
+            }
+            if (PyObject_CheckBuffer(obj.ptr()) && c.load_buffer(obj)) return c;
+            py::object arr = py::module_::import("numpy").attr("ascontiguousarray")(obj, "float64");
+            if (!c.load_buffer(arr)) throw py::type_error("expected a 1-D float64 column");
+            return c;
+        }
+
+        /// @return Borrowed values
+        std::span<const double> values() const { return values_; }
+
+        /// @return Missing-value mask (empty when every value is present)
+        fc::bitmap_view validity() const { return valid_; }
+
+    private:
+        bool load_buffer(py::handle obj) {
+            auto info = std::make_unique<py::buffer_info>(py::reinterpret_borrow<py::buffer>(obj).request());
+            if (info->ndim != 1 || info->format != py::format_descriptor<double>::format()) return false;
+            if (info->shape[0] > 1 && info->strides[0] != static_cast<py::ssize_t>(sizeof(double))) return false;
+            values_ = {static_cast<const double*>(info->ptr), static_cast<std::size_t>(info->shape[0])};
+            owner_ = py::reinterpret_borrow<py::object>(obj);
+            info_ = std::move(info);
+            return true;
+        }
+
+        void load_arrow_capsules(py::handle obj) {
+            py::object arrow = obj.attr("__arrow_c_array__")();
+            py::tuple pair = arrow.cast<py::tuple>();
+            auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(pair[0].ptr(), "arrow_schema"));
+            auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(pair[1].ptr(), "arrow_array"));
+            if (!schema || !array) throw py::error_already_set();
+            if (std::strcmp(schema->format, "g") != 0) {
+                if (!py::hasattr(obj, "cast")) throw py::type_error("Arrow column must be float64");
+                *this = from(obj.attr("cast")("float64"));
+                return;
+            }
+            view(*array);
+            owner_ = std::move(arrow);  // capsule destructors release the Arrow structures
+        }
+
+        void load_arrow_export(py::handle obj) {
+            auto release_schema = [](ArrowSchema* s) { if (s->release) s->release(s); delete s; };
+            auto release_array = [](ArrowArray* a) { if (a->release) a->release(a); delete a; };
+            std::shared_ptr<ArrowSchema> schema(new ArrowSchema{}, release_schema);
+            std::shared_ptr<ArrowArray> array(new ArrowArray{}, release_array);
+            obj.attr("_export_to_c")(reinterpret_cast<std::uintptr_t>(array.get()),
+                                     reinterpret_cast<std::uintptr_t>(schema.get()));
+            if (std::strcmp(schema->format, "g") != 0) {
+                *this = from(obj.attr("cast")("float64"));
+                return;
+            }
+            view(*array);
+            exported_ = std::move(array);
+        }
+
+        void view(const ArrowArray& array) {
+            if (array.n_buffers != 2) throw py::type_error("unexpected Arrow float64 layout");
+            const auto* data = static_cast<const double*>(array.buffers[1]);
+            values_ = {data + array.offset, static_cast<std::size_t>(array.length)};
+            if (array.null_count != 0 && array.buffers[0])
+                valid_ = {static_cast<const std::uint8_t*>(array.buffers[0]),
+                          static_cast<std::size_t>(array.offset)};
+        }
+
+        std::span<const double> values_;
+        fc::bitmap_view valid_;
+        py::object owner_;
+        std::unique_ptr<py::buffer_info> info_;
+        std::shared_ptr<ArrowArray> exported_;
+    };
+}
@@ -2,6 +2,8 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <sstream>
+
 // Include all FinCraftr headers
 #include <fincraftr/equity/basic.hpp>
 #include <fincraftr/equity/index.hpp>
@@ -16,6 +18,12 @@
 #include <fincraftr/rates/compounding.hpp>
 #include <fincraftr/rates/conversions.hpp>
 #include <fincraftr/rates/discount.hpp>
+#include <fincraftr/core/instrument.hpp>
+#include <fincraftr/core/shm_snapshot.hpp>
+#include <fincraftr/core/trace.hpp>
+
+#include "column.hpp"
+#include "vectorize.hpp"
 
 namespace py = pybind11;
 
@@ -29,62 +37,130 @@ PYBIND11_MODULE(pyfincraftr, m) {
     equity.def("market_cap", &fc::equity::market_cap,
         "Calculate the market capitalization of a company",
         py::arg("shares_outstanding"), py::arg("price"));
+    equity.def("market_cap", fcpy::vectorize(&fc::equity::market_cap),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("shares_outstanding"), py::arg("price"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    equity.def("ownership_fraction", &fc::equity::ownership_fraction,
+    equity.def("ownership_fraction", &fc::equity::ownership_fraction<>,
         "Calculate the ownership fraction for a given number of shares",
         py::arg("shares_owned"), py::arg("shares_outstanding"));
+    equity.def("ownership_fraction", fcpy::vectorize(&fc::equity::ownership_fraction<fc::policy::nan>),
+        "Vectorized over NumPy arrays with broadcasting (NaN where the scalar form raises)",
+        py::arg("shares_owned"), py::arg("shares_outstanding"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Equity returns
-    equity.def("return_simple", &fc::equity::return_simple,
+    equity.def("return_simple", &fc::equity::return_simple<>,
         "How much did this stock gain/lose relative to its previous price?",
         py::arg("Pt"), py::arg("Pt_prev"));
+    equity.def("return_simple", fcpy::vectorize(&fc::equity::return_simple<fc::policy::nan>),
+        "Vectorized over NumPy arrays with broadcasting (NaN where the scalar form raises)",
+        py::arg("Pt"), py::arg("Pt_prev"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Equity index functions
-    equity.def("index_price_weighted", &fc::equity::index_price_weighted,
+    equity.def("index_price_weighted",
+        [](py::object prices, double D) {
+            fcpy::column p = fcpy::column::from(prices);
+            py::gil_scoped_release release;
+            return fc::equity::index_price_weighted(p.values(), D, p.validity());
+        },
         "Calculate price-weighted index value",
         py::arg("prices"), py::arg("D"));
     
-    equity.def("index_cap_weighted", &fc::equity::index_cap_weighted,
+    equity.def("index_cap_weighted",
+        [](double prev_index, py::object caps_now, py::object caps_prev, double J) {
+            fcpy::column now = fcpy::column::from(caps_now);
+            fcpy::column prev = fcpy::column::from(caps_prev);
+            py::gil_scoped_release release;
+            return fc::equity::index_cap_weighted(prev_index, now.values(), prev.values(), J,
+                                                  now.validity(), prev.validity());
+        },
         "Calculate capitalization-weighted index value",
         py::arg("prev_index"), py::arg("caps_now"), py::arg("caps_prev"), py::arg("J") = 0.0);
     
-    equity.def("index_value_line_geo", &fc::equity::index_value_line_geo,
+    equity.def("index_value_line_geo",
+        [](double prev_index, py::object prices_now, py::object prices_prev) {
+            fcpy::column now = fcpy::column::from(prices_now);
+            fcpy::column prev = fcpy::column::from(prices_prev);
+            py::gil_scoped_release release;
+            return fc::equity::index_value_line_geo(prev_index, now.values(), prev.values(),
+                                                    now.validity(), prev.validity());
+        },
         "Calculate Value Line geometric index",
         py::arg("prev_index"), py::arg("prices_now"), py::arg("prices_prev"));
     
-    equity.def("index_value_line_arith", &fc::equity::index_value_line_arith,
+    equity.def("index_value_line_arith",
+        [](double prev_index, py::object prices_now, py::object prices_prev) {
+            fcpy::column now = fcpy::column::from(prices_now);
+            fcpy::column prev = fcpy::column::from(prices_prev);
+            py::gil_scoped_release release;
+            return fc::equity::index_value_line_arith(prev_index, now.values(), prev.values(),
+                                                      now.validity(), prev.validity());
+        },
         "Calculate Value Line arithmetic index",
         py::arg("prev_index"), py::arg("prices_now"), py::arg("prices_prev"));
     
     // Equity profit functions
-    equity.def("profit_simple", &fc::equity::profit_simple,
+    equity.def("profit_simple", &fc::equity::profit_simple<>,
         "Calculate simple profit from holding a stock position",
         py::arg("S0"), py::arg("ST"), py::arg("r"), py::arg("tau"));
+    equity.def("profit_simple", fcpy::vectorize(&fc::equity::profit_simple<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S0"), py::arg("ST"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    equity.def("profit_with_costs", &fc::equity::profit_with_costs,
+    equity.def("profit_with_costs", &fc::equity::profit_with_costs<>,
         "Calculate profit from holding a stock position with transaction costs and dividends",
         py::arg("S0"), py::arg("ST"), py::arg("r"), py::arg("tau"), py::arg("D_tau"), py::arg("C0"));
+    equity.def("profit_with_costs", fcpy::vectorize(&fc::equity::profit_with_costs<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S0"), py::arg("ST"), py::arg("r"), py::arg("tau"), py::arg("D_tau"), py::arg("C0"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Equity valuation functions
     equity.def("ddm_single_period", &fc::equity::ddm_single_period,
         "Single-period dividend discount model",
         py::arg("D1"), py::arg("S1"), py::arg("r"));
-    
-    equity.def("ddm_multi_period", &fc::equity::ddm_multi_period,
+    equity.def("ddm_single_period", fcpy::vectorize(&fc::equity::ddm_single_period),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("D1"), py::arg("S1"), py::arg("r"),
+        py::kw_only(), py::arg("threads") = 1);
+    
+    equity.def("ddm_multi_period",
+        [](py::object dividends, double ST, double r) {
+            fcpy::column d = fcpy::column::from(dividends);
+            py::gil_scoped_release release;
+            return fc::equity::ddm_multi_period(d.values(), ST, r, d.validity());
+        },
         "Multi-period dividend discount model with terminal value",
         py::arg("dividends"), py::arg("ST"), py::arg("r"));
     
-    equity.def("ddm_infinite", &fc::equity::ddm_infinite,
+    equity.def("ddm_infinite",
+        [](py::object dividends, double r) {
+            fcpy::column d = fcpy::column::from(dividends);
+            py::gil_scoped_release release;
+            return fc::equity::ddm_infinite(d.values(), r, d.validity());
+        },
         "Infinite-period dividend discount model (perpetuity)",
         py::arg("dividends"), py::arg("r"));
     
-    equity.def("cost_of_equity", &fc::equity::cost_of_equity,
+    equity.def("cost_of_equity", &fc::equity::cost_of_equity<>,
         "Calculate cost of equity using dividend growth model",
         py::arg("D1"), py::arg("S1"), py::arg("S0"));
+    equity.def("cost_of_equity", fcpy::vectorize(&fc::equity::cost_of_equity<fc::policy::nan>),
+        "Vectorized over NumPy arrays with broadcasting (NaN where the scalar form raises)",
+        py::arg("D1"), py::arg("S1"), py::arg("S0"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    equity.def("ddm_gordon_growth", &fc::equity::ddm_gordon_growth,
+    equity.def("ddm_gordon_growth", &fc::equity::ddm_gordon_growth<>,
         "Gordon growth model for dividend discount valuation",
         py::arg("D1"), py::arg("r"), py::arg("g"));
+    equity.def("ddm_gordon_growth", fcpy::vectorize(&fc::equity::ddm_gordon_growth<fc::policy::nan>),
+        "Vectorized over NumPy arrays with broadcasting (NaN where the scalar form raises)",
+        py::arg("D1"), py::arg("r"), py::arg("g"),
+        py::kw_only(), py::arg("threads") = 1);
 
     // Options module
     py::module_ options = m.def_submodule("options", "Options pricing and analysis functions");
@@ -93,89 +169,321 @@ PYBIND11_MODULE(pyfincraftr, m) {
     options.def("payoff_call", &fc::options::payoff_call,
         "Calculate the payoff of a European call option at expiration",
         py::arg("ST"), py::arg("K"));
+    options.def("payoff_call", fcpy::vectorize(&fc::options::payoff_call),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("ST"), py::arg("K"),
+        py::kw_only(), py::arg("threads") = 1);
     
     options.def("payoff_put", &fc::options::payoff_put,
         "Calculate the payoff of a European put option at expiration",
         py::arg("ST"), py::arg("K"));
+    options.def("payoff_put", fcpy::vectorize(&fc::options::payoff_put),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("ST"), py::arg("K"),
+        py::kw_only(), py::arg("threads") = 1);
     
     options.def("payoff_asian_call", &fc::options::payoff_asian_call,
         "Calculate the payoff of an Asian call option at expiration",
         py::arg("average_price"), py::arg("K"));
+    options.def("payoff_asian_call", fcpy::vectorize(&fc::options::payoff_asian_call),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("average_price"), py::arg("K"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Options binomial functions
     options.def("payoff_binomial_call", &fc::options::payoff_binomial_call,
         "Calculate call option payoffs in up and down states for binomial model",
         py::arg("Su"), py::arg("Sd"), py::arg("K"));
+    options.def("payoff_binomial_call",
+        [](fcpy::darray Su, fcpy::darray Sd, fcpy::darray K, unsigned threads) {
+            auto up = fcpy::vectorize([](double su, double sd, double k) {
+                return fc::options::payoff_binomial_call(su, sd, k).first;
+            });
+            auto down = fcpy::vectorize([](double su, double sd, double k) {
+                return fc::options::payoff_binomial_call(su, sd, k).second;
+            });
+            return py::make_tuple(up(Su, Sd, K, threads), down(Su, Sd, K, threads));
+        },
+        "Vectorized over NumPy arrays with broadcasting; returns (payoff_up, payoff_down) arrays",
+        py::arg("Su"), py::arg("Sd"), py::arg("K"),
+        py::kw_only(), py::arg("threads") = 1);
     
     options.def("hedge_ratio_binomial", &fc::options::hedge_ratio_binomial,
         "Calculate hedge ratio (delta) for binomial option model",
         py::arg("Cu"), py::arg("Cd"), py::arg("Su"), py::arg("Sd"));
+    options.def("hedge_ratio_binomial", fcpy::vectorize(&fc::options::hedge_ratio_binomial),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("Cu"), py::arg("Cd"), py::arg("Su"), py::arg("Sd"),
+        py::kw_only(), py::arg("threads") = 1);
     
     options.def("loan_binomial", &fc::options::loan_binomial,
         "Calculate loan amount needed for binomial replication strategy",
         py::arg("Cu"), py::arg("Cd"), py::arg("Su"), py::arg("Sd"), py::arg("r"));
+    options.def("loan_binomial", fcpy::vectorize(&fc::options::loan_binomial),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("Cu"), py::arg("Cd"), py::arg("Su"), py::arg("Sd"), py::arg("r"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    options.def("price_binomial_one_period", &fc::options::price_binomial_one_period,
+    options.def("price_binomial_one_period", &fc::options::price_binomial_one_period<>,
         "Price option using one-period binomial replication",
         py::arg("S0"), py::arg("Delta"), py::arg("B_hat"), py::arg("r"), py::arg("tau") = 1.0);
+    options.def("price_binomial_one_period", fcpy::vectorize(&fc::options::price_binomial_one_period<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S0"), py::arg("Delta"), py::arg("B_hat"), py::arg("r"), py::arg("tau") = 1.0,
+        py::kw_only(), py::arg("threads") = 1);
     
-    options.def("price_risk_neutral_one_period", &fc::options::price_risk_neutral_one_period,
+    options.def("price_risk_neutral_one_period", &fc::options::price_risk_neutral_one_period<>,
         "Price option using risk-neutral valuation in one-period binomial model",
         py::arg("S0"), py::arg("Su"), py::arg("Sd"), py::arg("Cu"), py::arg("Cd"), py::arg("r"), py::arg("tau") = 1.0);
+    options.def("price_risk_neutral_one_period", fcpy::vectorize(&fc::options::price_risk_neutral_one_period<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S0"), py::arg("Su"), py::arg("Sd"), py::arg("Cu"), py::arg("Cd"), py::arg("r"), py::arg("tau") = 1.0,
+        py::kw_only(), py::arg("threads") = 1);
     
     // Options parity functions
-    options.def("check_put_call_parity", &fc::options::check_put_call_parity,
+    options.def("check_put_call_parity", &fc::options::check_put_call_parity<>,
         "Check if put-call parity relationship holds within tolerance",
         py::arg("C"), py::arg("P"), py::arg("S"), py::arg("K"), py::arg("r"), py::arg("tau"),
         py::arg("D") = 0.0, py::arg("q") = NAN, py::arg("tol") = 1e-8);
+    options.def("check_put_call_parity", fcpy::vectorize(&fc::options::check_put_call_parity<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("C"), py::arg("P"), py::arg("S"), py::arg("K"), py::arg("r"), py::arg("tau"),
+        py::arg("D") = 0.0, py::arg("q") = NAN, py::arg("tol") = 1e-8,
+        py::kw_only(), py::arg("threads") = 1);
     
     // Options profit functions
-    options.def("profit_call", &fc::options::profit_call,
+    options.def("profit_call", &fc::options::profit_call<>,
         "Calculate profit/loss from holding a call option to expiration",
         py::arg("ST"), py::arg("K"), py::arg("premium"), py::arg("r"), py::arg("tau"));
+    options.def("profit_call", fcpy::vectorize(&fc::options::profit_call<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("ST"), py::arg("K"), py::arg("premium"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
 
     // Forwards module
     py::module_ forwards = m.def_submodule("forwards", "Forward contract pricing functions");
     
-    forwards.def("forward_price_no_div", &fc::forwards::forward_price_no_div,
+    forwards.def("forward_price_no_div", &fc::forwards::forward_price_no_div<>,
         "Calculate forward price for an asset with no dividends",
         py::arg("S"), py::arg("r"), py::arg("tau"));
+    forwards.def("forward_price_no_div", fcpy::vectorize(&fc::forwards::forward_price_no_div<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    forwards.def("forward_price_with_div", &fc::forwards::forward_price_with_div,
+    forwards.def("forward_price_with_div", &fc::forwards::forward_price_with_div<>,
         "Calculate forward price for an asset with known discrete dividend",
         py::arg("S"), py::arg("D"), py::arg("r"), py::arg("tau"));
+    forwards.def("forward_price_with_div", fcpy::vectorize(&fc::forwards::forward_price_with_div<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S"), py::arg("D"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    forwards.def("forward_price_cont_yield", &fc::forwards::forward_price_cont_yield,
+    forwards.def("forward_price_cont_yield", &fc::forwards::forward_price_cont_yield<>,
         "Calculate forward price for an asset with continuous dividend yield",
         py::arg("S"), py::arg("r"), py::arg("q"), py::arg("tau"));
+    forwards.def("forward_price_cont_yield", fcpy::vectorize(&fc::forwards::forward_price_cont_yield<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("S"), py::arg("r"), py::arg("q"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
 
     // Rates module
     py::module_ rates = m.def_submodule("rates", "Interest rate and discounting functions");
     
     // Compounding functions
-    rates.def("compound_discrete", &fc::rates::compound_discrete,
+    rates.def("compound_discrete", &fc::rates::compound_discrete<>,
         "Calculate compound interest with discrete compounding",
         py::arg("p0"), py::arg("r"), py::arg("m"), py::arg("years"));
-    
-    rates.def("compound_continuous", &fc::rates::compound_continuous,
+    rates.def("compound_discrete", fcpy::vectorize([](double p0, double r, double m, double years) {
+            return fc::rates::compound_discrete(p0, r, static_cast<int>(m), years);
+        }),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("p0"), py::arg("r"), py::arg("m"), py::arg("years"),
+        py::kw_only(), py::arg("threads") = 1);
+    
+    rates.def("compound_continuous", &fc::rates::compound_continuous<>,
         "Calculate compound interest with continuous compounding",
         py::arg("p0"), py::arg("r"), py::arg("t"));
+    rates.def("compound_continuous", fcpy::vectorize(&fc::rates::compound_continuous<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("p0"), py::arg("r"), py::arg("t"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Discount functions
-    rates.def("roll_forward_cont", &fc::rates::roll_forward_cont,
+    rates.def("roll_forward_cont", &fc::rates::roll_forward_cont<>,
         "Roll a value forward in time using continuous compounding",
         py::arg("P_t"), py::arg("r"), py::arg("tau"));
+    rates.def("roll_forward_cont", fcpy::vectorize(&fc::rates::roll_forward_cont<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("P_t"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    rates.def("roll_back_cont", &fc::rates::roll_back_cont,
+    rates.def("roll_back_cont", &fc::rates::roll_back_cont<>,
         "Discount a value back in time using continuous compounding",
         py::arg("P_t"), py::arg("r"), py::arg("tau"));
+    rates.def("roll_back_cont", fcpy::vectorize(&fc::rates::roll_back_cont<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("P_t"), py::arg("r"), py::arg("tau"),
+        py::kw_only(), py::arg("threads") = 1);
     
     // Conversion functions
-    rates.def("nominal_to_continuous", &fc::rates::nominal_to_continuous,
+    rates.def("nominal_to_continuous", &fc::rates::nominal_to_continuous<>,
         "Convert nominal (discrete) interest rate to continuous compounding rate",
         py::arg("R"), py::arg("m"));
+    rates.def("nominal_to_continuous", fcpy::vectorize(&fc::rates::nominal_to_continuous<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("R"), py::arg("m"),
+        py::kw_only(), py::arg("threads") = 1);
     
-    rates.def("continuous_to_nominal", &fc::rates::continuous_to_nominal,
+    rates.def("continuous_to_nominal", &fc::rates::continuous_to_nominal<>,
         "Convert continuous compounding rate to nominal (discrete) interest rate",
         py::arg("r"), py::arg("m"));
+    rates.def("continuous_to_nominal", fcpy::vectorize(&fc::rates::continuous_to_nominal<>),
+        "Vectorized over NumPy arrays with broadcasting",
+        py::arg("r"), py::arg("m"),
+        py::kw_only(), py::arg("threads") = 1);
+
+    // Hot-path instrumentation (populated only in FINCRAFTR_INSTRUMENT builds)
+    py::module_ instrument = m.def_submodule("instrument", "Per-function call counts and cycle histograms");
+    instrument.attr("enabled") = fc::instrument::enabled;
+    instrument.def("snapshot", [] {
+            std::vector<fc::instrument::function_stats> stats;
+            {
+                py::gil_scoped_release release;
+                stats = fc::instrument::snapshot();
+            }
+            py::list out;
+            for (const auto& f : stats) {
+                py::dict d;
+                d["name"] = f.name;
+                d["calls"] = f.calls;
+                d["elements"] = f.elements;
+                d["cycles"] = f.cycles;
+                d["threads"] = f.threads;
+                d["cycles_per_call"] = f.cycles_per_call();
+                d["cycles_per_element"] = f.cycles_per_element();
+                d["p50_cycles"] = f.percentile_cycles(50.0);
+                d["p99_cycles"] = f.percentile_cycles(99.0);
+                d["histogram"] = std::vector<std::uint64_t>(f.histogram.begin(), f.histogram.end());
+                out.append(std::move(d));
+            }
+            return out;
+        },
+        "Counters of every instrumented function summed over threads, most cycles first");
+    instrument.def("reset", &fc::instrument::reset, "Zero every counter",
+        py::call_guard<py::gil_scoped_release>());
+    instrument.def("report", &fc::instrument::report, "Counters formatted as a table",
+        py::call_guard<py::gil_scoped_release>());
+    instrument.def("ticks_per_ns", &fc::instrument::ticks_per_ns,
+        "Cycle counter ticks per nanosecond (0 when instrumentation is disabled)");
+
+    // Chrome-trace timeline of batch pipelines
+    py::module_ trace = m.def_submodule("trace", "Chrome trace spans recorded by batch entry points");
+    trace.def("start", &fc::trace::start, "Clear previous spans and begin recording");
+    trace.def("stop", &fc::trace::stop, "Stop recording; spans stay available for dump()");
+    trace.def("clear", &fc::trace::clear, "Drop every recorded span");
+    trace.def("active", &fc::trace::active, "True while recording");
+    trace.def("set_thread_name", &fc::trace::set_thread_name,
+        "Name the calling thread's track in exported traces", py::arg("name"));
+    trace.def("dump", &fc::trace::dump,
+        "Write Chrome trace JSON (chrome://tracing, ui.perfetto.dev); returns the number of spans",
+        py::arg("path"), py::call_guard<py::gil_scoped_release>());
+    trace.def("json", [] {
+            std::ostringstream os;
+            {
+                py::gil_scoped_release release;
+                fc::trace::write_chrome_json(os);
+            }
+            return os.str();
+        },
+        "Chrome trace JSON as a string");
+
+    struct py_span {
+        const char* name;
+        std::uint64_t arg = 0;
+        std::uint64_t begin = 0;
+        bool open = false;
+    };
+    py::class_<py_span>(trace, "span",
+        "Context manager recording its body as one span: with fincraftr.trace.span(\"curves\"): ...")
+        .def(py::init([](const std::string& name, std::uint64_t arg) {
+            return py_span{fc::trace::intern(name), arg};
+        }), py::arg("name"), py::arg("arg") = 0)
+        .def("__enter__", [](py_span& s) -> py_span& {
+            s.open = fc::trace::active();
+            s.begin = fc::trace::now();
+            return s;
+        }, py::return_value_policy::reference)
+        .def("__exit__", [](py_span& s, py::args) {
+            if (s.open) fc::trace::record(s.name, s.begin, fc::trace::now(), s.arg);
+            s.open = false;
+            return false;
+        });
+
+#ifdef FINCRAFTR_HAS_SHM
+    // Shared-memory market data snapshots
+    py::module_ shm = m.def_submodule("shm", "Shared-memory market data snapshots for multi-process workers");
+
+    py::class_<fc::shm::snapshot_writer>(shm, "Writer",
+        "Publishes named float64 arrays as versioned POSIX shared-memory snapshots")
+        .def(py::init<std::string, unsigned>(), py::arg("base"), py::arg("keep") = 2)
+        .def("publish",
+            [](fc::shm::snapshot_writer& w, const py::dict& arrays) {
+                // Convert every entry before staging any, and unstage on failure, so a bad key or
+                // array cannot leave spans into the released temporaries for the next publish()
+                std::vector<std::string> names;
+                std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> held;
+                names.reserve(arrays.size());
+                held.reserve(arrays.size());
+                for (auto item : arrays) {
+                    names.push_back(item.first.cast<std::string>());
+                    held.emplace_back(py::reinterpret_borrow<py::object>(item.second));
+                }
+                try {
+                    for (std::size_t k = 0; k < held.size(); ++k) {
+                        const auto& a = held[k];
+                        std::vector<std::size_t> shape(a.shape(), a.shape() + a.ndim());
+                        if (shape.empty()) shape.push_back(1);
+                        w.add(std::move(names[k]), {a.data(), static_cast<std::size_t>(a.size())}, std::move(shape));
+                    }
+                } catch (...) {
+                    w.clear();
+                    throw;
+                }
+                py::gil_scoped_release release;
+                return w.publish();
+            },
+            "Write the arrays as the next version and make it current; returns the version",
+            py::arg("arrays"))
+        .def("remove", &fc::shm::snapshot_writer::remove,
+            "Unlink the snapshot; attached readers keep their views")
+        .def_property_readonly("base", &fc::shm::snapshot_writer::base);
+
+    py::class_<fc::shm::snapshot>(shm, "Snapshot",
+        "Read-only view of one snapshot version; arrays are zero-copy NumPy views")
+        .def_property_readonly("version", &fc::shm::snapshot::version)
+        .def_property_readonly("latest_version", &fc::shm::snapshot::latest_version)
+        .def("stale", &fc::shm::snapshot::stale,
+            "True if a newer version has been published since attaching")
+        .def("keys", [](const fc::shm::snapshot& s) {
+            py::list names;
+            for (std::size_t k = 0; k < s.size(); ++k) names.append(py::str(std::string(s.name(k))));
+            return names;
+        })
+        .def("__len__", &fc::shm::snapshot::size)
+        .def("__contains__", [](const fc::shm::snapshot& s, const std::string& name) { return s.contains(name); })
+        .def("__getitem__", [](py::object self, const std::string& name) {
+            const auto& s = self.cast<const fc::shm::snapshot&>();
+            if (!s.contains(name)) throw py::key_error(name);
+            std::span<const double> values = s[name];
+            std::vector<std::size_t> shape = s.shape(name);
+            py::array_t<double> view(shape, values.data(), self);
+            view.attr("setflags")(py::arg("write") = false);
+            return view;
+        });
+
+    shm.def("attach", &fc::shm::snapshot::attach,
+        "Attach to the newest published version of a snapshot",
+        py::arg("base"));
+#endif
 }
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fincraftr/core/batch.hpp>
+
+namespace fcpy {
+    namespace py = pybind11;
+
+    /// Array argument of vectorized overloads; any array-like input is cast to float64
+    using darray = py::array_t<double, py::array::forcecast>;
+
+    namespace detail {
+        template <class F> struct signature : signature<decltype(&F::operator())> {};
+        template <class R, class... A> struct signature<R (*)(A...)> {
+            using result = R;
+            static constexpr std::size_t arity = sizeof...(A);
+        };
+        template <class C, class R, class... A> struct signature<R (C::*)(A...) const> {
+            using result = R;
+            static constexpr std::size_t arity = sizeof...(A);
+        };
+
+        template <std::size_t> using as_darray = darray;
+
+        /// Operands ready for fc::batch::map, with the arrays that own their buffers
+        template <std::size_t N>
+        struct prepared {
+            std::array<darray, N> arrays;
+            std::array<fc::batch::operand, N> operands;
+            std::vector<py::ssize_t> shape;
+            std::size_t size = 1;
+        };
+
+        /// Broadcast the inputs with NumPy rules
+        /// @throws py::value_error if the shapes are incompatible
+        /// @note Size-1 inputs become stride-0 operands and C-contiguous inputs of the full
+        ///       shape are used in place; anything else is materialized once with broadcast_to.
+        template <std::size_t N>
+        prepared<N> prepare(std::array<darray, N> arrays) {
+            prepared<N> p;
+            py::ssize_t nd = 0;
+            for (const darray& a : arrays) nd = std::max<py::ssize_t>(nd, a.ndim());
+            p.shape.assign(static_cast<std::size_t>(nd), 1);
+            for (const darray& a : arrays) {
+                for (py::ssize_t d = 0; d < a.ndim(); ++d) {
+                    const py::ssize_t s = a.shape(d);
+                    py::ssize_t& o = p.shape[static_cast<std::size_t>(nd - a.ndim() + d)];
+                    if (s == 1) continue;
+                    if (o == 1) o = s;
+                    else if (o != s) throw py::value_error("operands could not be broadcast together");
+                }
+            }
+            for (py::ssize_t s : p.shape) p.size *= static_cast<std::size_t>(s);
+
+            for (std::size_t k = 0; k < N; ++k) {
+                darray& a = arrays[k];
+                const bool full_shape = a.ndim() == nd
+                    && std::equal(p.shape.begin(), p.shape.end(), a.shape());
+                if (a.size() == 1) {
+                    p.operands[k] = {a.data(), 0};
+                } else if (full_shape && (a.flags() & py::array::c_style)) {
+                    p.operands[k] = {a.data(), 1};
+                } else {
+                    py::module_ np = py::module_::import("numpy");
+                    a = np.attr("ascontiguousarray")(np.attr("broadcast_to")(a, py::cast(p.shape))).template cast<darray>();
+                    p.operands[k] = {a.data(), 1};
+                }
+            }
+            p.arrays = std::move(arrays);
+            return p;
+        }
+
+        template <class R, class F, std::size_t N>
+        py::object run(const F& f, std::array<darray, N> arrays, unsigned threads) {
+            prepared<N> p = prepare(std::move(arrays));
+            py::array_t<R> out(p.shape);
+            R* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                fc::batch::map(f, p.size, p.operands, dst, threads);
+            }
+            if (p.shape.empty()) return py::cast(dst[0]);
+            return out;
+        }
+
+        template <class F, std::size_t... I>
+        auto vectorize(F f, std::index_sequence<I...>) {
+            using R = typename signature<F>::result;
+            return [f](as_darray<I>... args, unsigned threads) -> py::object {
+                return run<R>(f, std::array<darray, sizeof...(I)>{std::move(args)...}, threads);
+            };
+        }
+    }
+
+    /// Wrap a scalar kernel of double arguments as a NumPy-broadcasting overload
+    /// @param f Function pointer or lambda taking only doubles
+    /// @return Callable for py::module_::def taking one array per argument plus a thread count
+    /// @note The GIL is released while the C++ batch loop runs over the raw buffers, split
+    ///       across `threads` pool threads (0 = all cores). All-scalar inputs return a Python
+    ///       scalar; otherwise the result has the broadcast shape.
+    template <class F>
+    auto vectorize(F f) {
+        return detail::vectorize(f, std::make_index_sequence<detail::signature<F>::arity>{});
+    }
+}
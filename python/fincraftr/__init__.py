@@ -15,33 +15,70 @@ Modules:
 __version__ = "1.0.0"
 __author__ = "FinCraftr Contributors"
 
-# Import the compiled C++ extension
-try:
-    from .pyfincraftr import *
-    from .pyfincraftr import equity, options, forwards, rates
-    
-    # Make functions available at top level for convenience
-    from .pyfincraftr.equity import return_simple
-    from .pyfincraftr.rates import compound_discrete, compound_continuous
-    from .pyfincraftr.options import payoff_call, payoff_put
-    from .pyfincraftr.forwards import forward_price_no_div
-    
-except ImportError as e:
-    import warnings
-    warnings.warn(f"Could not import C++ extension: {e}. "
-                  "Using Python fallback implementations.")
-    
-    # Import Python fallback implementations
-    from . import equity
-    from . import options  
-    from . import forwards
-    from . import rates
-    
-    # Import key functions for top-level access
-    from .equity.returns import return_simple
-    from .rates.compounding import compound_discrete, compound_continuous
-    from .options.payoff import payoff_call, payoff_put
-    from .forwards.pricing import forward_price_no_div
+import importlib
+import warnings
+
+# Submodules and top-level functions are resolved on first attribute access (PEP 562),
+# so `import fincraftr` loads neither the C++ extension nor the fallback modules.
+_SUBMODULES = ("equity", "options", "forwards", "rates")
+
+# Submodules with no pure-Python fallback
+_EXTENSION_ONLY = ("shm", "instrument", "trace")
+
+# Top-level function -> (submodule, fallback module defining it)
+_FUNCTIONS = {
+    "return_simple": ("equity", "returns"),
+    "compound_discrete": ("rates", "compounding"),
+    "compound_continuous": ("rates", "compounding"),
+    "payoff_call": ("options", "payoff"),
+    "payoff_put": ("options", "payoff"),
+    "forward_price_no_div": ("forwards", "pricing"),
+}
+
+_extension = None
+
+
+def _load_extension():
+    """Import the compiled C++ extension once; None if it is unavailable."""
+    global _extension
+    if _extension is None:
+        try:
+            _extension = importlib.import_module(".pyfincraftr", __name__)
+        except ImportError as e:
+            warnings.warn(f"Could not import C++ extension: {e}. "
+                          "Using Python fallback implementations.")
+            _extension = False
+    return _extension or None
+
+
+def __getattr__(name):
+    if name in _SUBMODULES:
+        extension = _load_extension()
+        if extension is not None:
+            value = getattr(extension, name)
+        else:
+            value = importlib.import_module(f".{name}", __name__)
+    elif name in _EXTENSION_ONLY:
+        extension = _load_extension()
+        if extension is None or not hasattr(extension, name):
+            raise AttributeError(f"fincraftr.{name} requires the compiled C++ extension")
+        value = getattr(extension, name)
+    elif name in _FUNCTIONS:
+        package, module = _FUNCTIONS[name]
+        extension = _load_extension()
+        if extension is not None:
+            value = getattr(getattr(extension, package), name)
+        else:
+            value = getattr(importlib.import_module(f".{package}.{module}", __name__), name)
+    else:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(__all__))
+
 
 __all__ = [
     "equity",
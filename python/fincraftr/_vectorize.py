@@ -0,0 +1,26 @@
+import numpy as np
+
+
+def result(x):
+    """Return 0-d results as a Python float and anything else as an ndarray."""
+    x = np.asarray(x)
+    return float(x) if x.ndim == 0 else x
+
+
+def reject(invalid, value, message: str):
+    """Mask invalid elements of a broadcast result.
+
+    Scalar inputs raise ValueError like the compiled scalar overloads; array inputs
+    get NaN at the invalid positions like the compiled array overloads.
+    """
+    invalid = np.asarray(invalid)
+    if invalid.ndim == 0:
+        if invalid:
+            raise ValueError(message)
+        return result(value)
+    return np.where(invalid, np.nan, value)
+
+
+def column(x) -> np.ndarray:
+    """View a 1-D sequence (list, ndarray, pyarrow array, ...) as float64."""
+    return np.asarray(x, dtype=np.float64).reshape(-1)
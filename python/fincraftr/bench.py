@@ -0,0 +1,233 @@
+"""
+Throughput benchmark: compiled bindings vs. Python fallbacks (vs. direct C++)
+
+Times every elementwise and sequence function in scalar mode (one call with Python
+floats, reported as calls/sec) and array mode (one call over a NumPy batch, reported as
+ns/element), for the pyfincraftr bindings and the pure-NumPy fallback modules side by side.
+Passing the JSON written by the native suite (fincraftr_bench --json FILE) adds a direct
+C++ column, which shows the cost of crossing the language boundary.
+
+Usage:
+    python -m fincraftr.bench [--filter SUBSTR] [--sizes 1000,100000] [--repeat N]
+                              [--min-time SECONDS] [--threads N] [--cpp FILE] [--json FILE]
+                              [--quick]
+
+Only NumPy is required, so the module runs unchanged on a production host.
+"""
+
+import argparse
+import importlib
+import json
+import platform
+import statistics
+import sys
+import timeit
+
+import numpy as np
+
+# (package, function, fallback module, arguments). An argument is a (low, high) range
+# sampled uniformly, or a constant passed unchanged in both modes.
+ELEMENTWISE = [
+    ("equity", "market_cap", "basic", [(1e6, 1e9), (1, 500)]),
+    ("equity", "ownership_fraction", "basic", [(0, 1e6), (1e6, 1e9)]),
+    ("equity", "return_simple", "returns", [(50, 150), (50, 150)]),
+    ("equity", "profit_simple", "profit", [(50, 150), (50, 150), (0, 0.1), (0, 2)]),
+    ("equity", "profit_with_costs", "profit", [(50, 150), (50, 150), (0, 0.1), (0, 2), (0, 5), (50, 150)]),
+    ("equity", "ddm_single_period", "valuation", [(0, 5), (50, 150), (0.02, 0.12)]),
+    ("equity", "cost_of_equity", "valuation", [(0, 5), (50, 150), (50, 150)]),
+    ("equity", "ddm_gordon_growth", "valuation", [(0, 5), (0.08, 0.12), (0, 0.06)]),
+    ("options", "payoff_call", "payoff", [(50, 150), (50, 150)]),
+    ("options", "payoff_put", "payoff", [(50, 150), (50, 150)]),
+    ("options", "payoff_asian_call", "payoff", [(50, 150), (50, 150)]),
+    ("options", "profit_call", "profit", [(50, 150), (50, 150), (0, 10), (0, 0.1), (0, 2)]),
+    ("options", "payoff_binomial_call", "binomial", [(110, 130), (70, 90), (80, 120)]),
+    ("options", "hedge_ratio_binomial", "binomial", [(10, 30), (0, 5), (110, 130), (70, 90)]),
+    ("options", "loan_binomial", "binomial", [(10, 30), (0, 5), (110, 130), (70, 90), (0, 0.1)]),
+    ("options", "price_binomial_one_period", "binomial", [(50, 150), (0, 1), (0, 50), (0, 0.1), (0.5, 2)]),
+    ("options", "price_risk_neutral_one_period", "binomial",
+     [(95, 105), (110, 130), (70, 90), (10, 30), (0, 5), (0, 0.1), (0.5, 2)]),
+    ("options", "check_put_call_parity", "parity", [(0, 20), (0, 20), (50, 150), (50, 150), (0, 0.1), (0, 2)]),
+    ("forwards", "forward_price_no_div", "pricing", [(50, 150), (0, 0.1), (0, 2)]),
+    ("forwards", "forward_price_with_div", "pricing", [(50, 150), (0, 5), (0, 0.1), (0, 2)]),
+    ("forwards", "forward_price_cont_yield", "pricing", [(50, 150), (0, 0.1), (0, 0.05), (0, 2)]),
+    ("rates", "compound_discrete", "compounding", [(100, 1e4), (0, 0.1), 12, (0, 30)]),
+    ("rates", "compound_continuous", "compounding", [(100, 1e4), (0, 0.1), (0, 30)]),
+    ("rates", "roll_forward_cont", "discount", [(100, 1e4), (0, 0.1), (0, 30)]),
+    ("rates", "roll_back_cont", "discount", [(100, 1e4), (0, 0.1), (0, 30)]),
+    ("rates", "nominal_to_continuous", "conversions", [(0, 0.1), 12]),
+    ("rates", "continuous_to_nominal", "conversions", [(0, 0.1), 12]),
+]
+
+# (package, function, fallback module, column ranges, trailing constant arguments,
+#  leading constant arguments). Scalar mode passes 16-element Python lists.
+SEQUENCE = [
+    ("equity", "index_price_weighted", "index", [(10, 500)], [10.0], []),
+    ("equity", "index_cap_weighted", "index", [(1e6, 1e9), (1e6, 1e9)], [], [100.0]),
+    ("equity", "index_value_line_geo", "index", [(10, 500), (10, 500)], [], [100.0]),
+    ("equity", "index_value_line_arith", "index", [(10, 500), (10, 500)], [], [100.0]),
+    ("equity", "ddm_multi_period", "valuation", [(0, 5)], [100.0, 0.08], []),
+    ("equity", "ddm_infinite", "valuation", [(0, 5)], [0.08], []),
+]
+
+SCALAR_COLUMN = 16
+
+
+def _sample(spec, n, rng):
+    if isinstance(spec, tuple):
+        values = rng.uniform(spec[0], spec[1], n)
+        return values if n is not None else float(values)
+    return spec
+
+
+def _time(call, min_time, repeat):
+    """Median seconds per call over `repeat` runs of at least `min_time` seconds each."""
+    timer = timeit.Timer(call)
+    number = 1
+    while True:
+        elapsed = timer.timeit(number)
+        if elapsed >= min_time / 10 or number >= 1 << 30:
+            break
+        number *= 2
+    number = max(1, int(number * min_time / max(elapsed, 1e-9)))
+    return statistics.median(timer.repeat(repeat=repeat, number=number)) / number
+
+
+def _implementations(package, module):
+    """Return {label: module} for the binding and the fallback that are importable."""
+    impls = {}
+    try:
+        impls["binding"] = getattr(importlib.import_module("fincraftr.pyfincraftr"), package)
+    except ImportError:
+        pass
+    impls["fallback"] = importlib.import_module(f"fincraftr.{package}.{module}")
+    return impls
+
+
+def _run_case(impls, name, scalar_args, array_args, elements, threads, opts):
+    """Time scalar and array calls of every implementation; None marks a failure."""
+    scalar, array = {}, {}
+    for label, module in impls.items():
+        f = getattr(module, name)
+        kwargs = {"threads": threads} if label == "binding" and threads != 1 and elements else {}
+        try:
+            if scalar_args is not None:
+                f(*scalar_args)
+                scalar[label] = 1.0 / _time(lambda: f(*scalar_args), opts.min_time, opts.repeat)
+            for n, args in array_args.items():
+                f(*args, **kwargs)
+                array[(label, n)] = _time(lambda: f(*args, **kwargs), opts.min_time, opts.repeat) * 1e9 / n
+        except Exception as e:  # report and keep going; a broken binding should not hide the rest
+            print(f"  {label} {name}: {type(e).__name__}: {e}", file=sys.stderr)
+            scalar.setdefault(label, None)
+    return scalar, array
+
+
+def _load_cpp(path):
+    if not path:
+        return {}
+    with open(path) as f:
+        data = json.load(f)
+    return {(b["name"], b["size"]): b["median_ns"] for b in data.get("benchmarks", [])}
+
+
+def _fmt_rate(x):
+    if x is None:
+        return "-"
+    for unit, scale in (("G", 1e9), ("M", 1e6), ("k", 1e3)):
+        if x >= scale:
+            return f"{x / scale:.2f}{unit}"
+    return f"{x:.0f}"
+
+
+def _fmt_ns(x):
+    return "-" if x is None else f"{x:.3f}"
+
+
+def _ratio(a, b):
+    return "-" if a is None or b is None or b == 0 else f"{a / b:.1f}x"
+
+
+def run(opts):
+    rng = np.random.default_rng(42)
+    cpp = _load_cpp(opts.cpp)
+    rows = []
+
+    for package, name, module, args in ELEMENTWISE:
+        qualified = f"{package}.{name}"
+        if opts.filter and opts.filter not in qualified:
+            continue
+        scalar_args = [_sample(a, None, rng) for a in args]
+        array_args = {n: [_sample(a, n, rng) for a in args] for n in opts.sizes}
+        scalar, array = _run_case(_implementations(package, module), name, scalar_args, array_args,
+                                  True, opts.threads, opts)
+        rows.append((package, name, scalar, array))
+
+    for package, name, module, columns, trailing, leading in SEQUENCE:
+        qualified = f"{package}.{name}"
+        if opts.filter and opts.filter not in qualified:
+            continue
+        scalar_args = leading + [list(_sample(c, SCALAR_COLUMN, rng)) for c in columns] + trailing
+        array_args = {n: leading + [_sample(c, n, rng) for c in columns] + trailing for n in opts.sizes}
+        scalar, array = _run_case(_implementations(package, module), name, scalar_args, array_args,
+                                  False, 1, opts)
+        rows.append((package, name, scalar, array))
+
+    print("Scalar calls (calls/sec, higher is better)")
+    print(f"{'function':<42} {'binding':>10} {'fallback':>10} {'speedup':>8}")
+    for package, name, scalar, _ in rows:
+        b, f = scalar.get("binding"), scalar.get("fallback")
+        print(f"{package + '.' + name:<42} {_fmt_rate(b):>10} {_fmt_rate(f):>10} {_ratio(b, f):>8}")
+
+    print()
+    print("Array calls (ns/element, lower is better)")
+    print(f"{'function':<42} {'size':>8} {'c++':>9} {'binding':>9} {'fallback':>9} {'speedup':>8} {'overhead':>9}")
+    for package, name, _, array in rows:
+        for n in opts.sizes:
+            native = cpp.get((f"{package}/{name}", n))
+            b, f = array.get(("binding", n)), array.get(("fallback", n))
+            overhead = "-" if native is None or b is None else f"{b - native:+.3f}"
+            print(f"{package + '.' + name:<42} {n:>8} {_fmt_ns(native):>9} {_fmt_ns(b):>9} {_fmt_ns(f):>9} "
+                  f"{_ratio(f, b):>8} {overhead:>9}")
+
+    if opts.json:
+        report = {
+            "python": platform.python_version(),
+            "numpy": np.__version__,
+            "machine": platform.machine(),
+            "threads": opts.threads,
+            "functions": [
+                {
+                    "name": f"{package}.{name}",
+                    "scalar_calls_per_sec": scalar,
+                    "array_ns_per_element": {f"{label}/{n}": v for (label, n), v in array.items()},
+                    "cpp_ns_per_element": {str(n): cpp[(f"{package}/{name}", n)]
+                                           for n in opts.sizes if (f"{package}/{name}", n) in cpp},
+                }
+                for package, name, scalar, array in rows
+            ],
+        }
+        with open(opts.json, "w") as f:
+            json.dump(report, f, indent=2)
+    return rows
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="python -m fincraftr.bench", description=__doc__.split("\n\n")[0])
+    parser.add_argument("--filter", default="", help="only functions whose package.name contains this")
+    parser.add_argument("--sizes", default="1000,100000", help="comma-separated array sizes")
+    parser.add_argument("--repeat", type=int, default=5, help="timed runs per measurement (median is reported)")
+    parser.add_argument("--min-time", type=float, default=0.05, help="seconds per timed run")
+    parser.add_argument("--threads", type=int, default=1, help="threads= passed to array bindings (0 = all cores)")
+    parser.add_argument("--cpp", default="", help="fincraftr_bench --json output to add a direct C++ column")
+    parser.add_argument("--json", default="", help="also write results to this file")
+    parser.add_argument("--quick", action="store_true", help="short runs for a smoke test")
+    opts = parser.parse_args(argv)
+    opts.sizes = [int(s) for s in opts.sizes.split(",") if s]
+    if opts.quick:
+        opts.repeat, opts.min_time = 3, 0.01
+    run(opts)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,32 @@
+import importlib
+
+# Fallback functions are imported from their defining module on first access (PEP 562)
+_FUNCTIONS = {
+    "market_cap": "basic",
+    "ownership_fraction": "basic",
+    "index_price_weighted": "index",
+    "index_cap_weighted": "index",
+    "index_value_line_geo": "index",
+    "index_value_line_arith": "index",
+    "profit_simple": "profit",
+    "profit_with_costs": "profit",
+    "return_simple": "returns",
+    "ddm_single_period": "valuation",
+    "ddm_multi_period": "valuation",
+    "ddm_infinite": "valuation",
+    "cost_of_equity": "valuation",
+    "ddm_gordon_growth": "valuation",
+}
+
+
+def __getattr__(name):
+    module = _FUNCTIONS.get(name)
+    if module is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(f".{module}", __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(_FUNCTIONS))
@@ -1,7 +1,12 @@
+import numpy as np
+
+from .._vectorize import reject, result
+
 def market_cap(shares_outstanding: float, price: float) -> float:
-    return shares_outstanding * price
+    return result(np.multiply(shares_outstanding, price))
 
 def ownership_fraction(shares_owned: float, shares_outstanding: float) -> float:
-    if shares_outstanding <= 0:
-        raise ValueError("shares_outstanding must be positive")
-    return shares_owned / shares_outstanding
\ No newline at end of file
+    shares_owned, shares_outstanding = np.asarray(shares_owned, float), np.asarray(shares_outstanding, float)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        value = shares_owned / shares_outstanding
+    return reject(shares_outstanding <= 0, value, "shares_outstanding must be positive")
@@ -1,27 +1,25 @@
-import math
+import numpy as np
 from typing import Sequence
 
+from .._vectorize import column
+
 def index_price_weighted(prices: list[float], D: float) -> float:
-    return sum(prices) / D
+    return float(column(prices).sum() / D)
 
 def index_cap_weighted(prev_index: float,
                        caps_now: list[float],
                        caps_prev: list[float],
                        J: float=0.0) -> float:
-    return prev_index * (sum(caps_now) / (sum(caps_prev) + J))
+    return float(prev_index * (column(caps_now).sum() / (column(caps_prev).sum() + J)))
 
 def index_value_line_geo(prev_index: float,
                          prices_now: Sequence[float],
                          prices_prev: Sequence[float]) -> float:
-    n = len(prices_now)
-    product = 1.0
-    for c_now, c_prev in zip(prices_now, prices_prev):
-        product *= c_now / c_prev
-    return prev_index * (product ** (1.0 / n))
+    ratios = column(prices_now) / column(prices_prev)
+    return float(prev_index * np.exp(np.log(ratios).mean()))
 
 def index_value_line_arith(prev_index: float,
                            prices_now: Sequence[float],
                            prices_prev: Sequence[float]) -> float:
-    n = len(prices_now)
-    ratios = [(c_now / c_prev) for c_now, c_prev in zip(prices_now, prices_prev)]
-    return prev_index * (sum(ratios) / n)
\ No newline at end of file
+    ratios = column(prices_now) / column(prices_prev)
+    return float(prev_index * ratios.mean())
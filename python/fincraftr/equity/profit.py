@@ -1,7 +1,9 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 def profit_simple(S0: float, ST: float, r: float, tau: float) -> float:
-    return ST - S0 * math.exp(r * tau)
+    return result(np.subtract(ST, np.multiply(S0, np.exp(np.multiply(r, tau)))))
 
 def profit_with_costs(S0: float, ST: float, r: float, tau: float, D_tau: float, C0: float) -> float:
-    return ST + D_tau - C0 * math.exp(r * tau)
\ No newline at end of file
+    return result(np.add(ST, D_tau) - np.multiply(C0, np.exp(np.multiply(r, tau))))
@@ -1,4 +1,9 @@
+import numpy as np
+
+from .._vectorize import reject
+
 def return_simple(Pt: float, Pt_prev: float) -> float:
-    if Pt_prev == 0:
-        raise ValueError("Previous price must be nonzero")
-    return (Pt / Pt_prev) - 1.0
+    Pt, Pt_prev = np.asarray(Pt, float), np.asarray(Pt_prev, float)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        value = Pt / Pt_prev - 1.0
+    return reject(Pt_prev == 0, value, "Previous price must be nonzero")
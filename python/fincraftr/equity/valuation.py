@@ -1,21 +1,32 @@
+import numpy as np
+
+from .._vectorize import column, reject, result
+
+def _discount_factors(T: int, r: float) -> np.ndarray:
+    return np.power(1.0 + r, -np.arange(1, T + 1, dtype=np.float64))
+
 def ddm_single_period(D1: float, S1: float, r: float) -> float:
-    return (D1 + S1) / (1.0 + r)
+    return result(np.add(D1, S1) / np.add(1.0, r))
 
 def ddm_multi_period(dividends: list[float], ST: float, r: float) -> float:
-    T = len(dividends)
-    pv = sum(Dt / (1.0 + r)**(t+1) for t, Dt in enumerate(dividends))
-    pv += ST / (1.0 + r)**T
+    dividends = column(dividends)
+    T = dividends.size
+    pv = float(dividends @ _discount_factors(T, r))
+    pv += ST * float(np.power(1.0 + r, -float(T)))
     return pv
 
 def ddm_infinite(dividends: list[float], r: float) -> float:
-    return sum(Dt / (1.0 + r)**(t+1) for t, Dt in enumerate(dividends))
+    dividends = column(dividends)
+    return float(dividends @ _discount_factors(dividends.size, r))
 
 def cost_of_equity(D1: float, S1: float, S0: float) -> float:
-    if S0 == 0:
-        raise ValueError("Current price must be nonzero")
-    return (D1 + S1) / S0 - 1.0
+    S0 = np.asarray(S0, float)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        value = np.add(D1, S1) / S0 - 1.0
+    return reject(S0 == 0, value, "Current price must be nonzero")
 
 def ddm_gordon_growth(D1: float, r: float, g: float) -> float:
-    if g >= r:
-        raise ValueError("Growth rate must be less than discount rate for convergence")
-    return D1 / (r - g)
\ No newline at end of file
+    r, g = np.asarray(r, float), np.asarray(g, float)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        value = np.divide(D1, r - g)
+    return reject(g >= r, value, "Growth rate must be less than discount rate for convergence")
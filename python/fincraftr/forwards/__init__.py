@@ -0,0 +1,21 @@
+import importlib
+
+# Fallback functions are imported from their defining module on first access (PEP 562)
+_FUNCTIONS = {
+    "forward_price_no_div": "pricing",
+    "forward_price_with_div": "pricing",
+    "forward_price_cont_yield": "pricing",
+}
+
+
+def __getattr__(name):
+    module = _FUNCTIONS.get(name)
+    if module is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(f".{module}", __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(_FUNCTIONS))
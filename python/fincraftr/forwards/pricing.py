@@ -1,10 +1,12 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 def forward_price_no_div(S: float, r: float, tau: float) -> float:
-    return S * math.exp(r * tau)
+    return result(np.multiply(S, np.exp(np.multiply(r, tau))))
 
 def forward_price_with_div(S: float, D: float, r: float, tau: float) -> float:
-    return (S - D) * math.exp(r * tau)
+    return result(np.subtract(S, D) * np.exp(np.multiply(r, tau)))
 
 def forward_price_cont_yield(S: float, r: float, q: float, tau: float) -> float:
-    return S * math.exp((r - q) * tau)
+    return result(np.multiply(S, np.exp(np.subtract(r, q) * tau)))
@@ -0,0 +1,28 @@
+import importlib
+
+# Fallback functions are imported from their defining module on first access (PEP 562)
+_FUNCTIONS = {
+    "payoff_binomial_call": "binomial",
+    "hedge_ratio_binomial": "binomial",
+    "loan_binomial": "binomial",
+    "price_binomial_one_period": "binomial",
+    "price_risk_neutral_one_period": "binomial",
+    "check_put_call_parity": "parity",
+    "payoff_call": "payoff",
+    "payoff_put": "payoff",
+    "payoff_asian_call": "payoff",
+    "profit_call": "profit",
+}
+
+
+def __getattr__(name):
+    module = _FUNCTIONS.get(name)
+    if module is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(f".{module}", __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(_FUNCTIONS))
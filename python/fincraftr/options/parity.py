@@ -1,11 +1,13 @@
-import math
+import numpy as np
 
 def check_put_call_parity(C: float, P: float, S: float, K: float, r: float, tau: float,
                           D: float=0.0, q: float=None, tol: float=1e-6) -> bool:
+    discount = np.exp(-np.multiply(r, tau))
     if q is None:  # discrete dividend case
-        lhs = P + S
-        rhs = C + D + K * math.exp(-r * tau)
+        lhs = np.add(P, S)
+        rhs = np.add(C, D) + np.multiply(K, discount)
     else:  # continuous yield
-        lhs = P + S * math.exp((q - r) * tau)
-        rhs = C + K * math.exp(-r * tau)
-    return abs(lhs - rhs) < tol
+        lhs = np.add(P, np.multiply(S, np.exp(np.subtract(q, r) * tau)))
+        rhs = np.add(C, np.multiply(K, discount))
+    ok = np.abs(lhs - rhs) < tol
+    return bool(ok) if ok.ndim == 0 else ok
@@ -1,6 +1,8 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 def profit_call(ST: float, K: float, premium: float, r: float, tau: float) -> float:
-    payoff = max(ST - K, 0.0)
-    cost = premium * math.exp(r * tau)
-    return payoff - cost
+    payoff = np.maximum(np.subtract(ST, K), 0.0)
+    cost = np.multiply(premium, np.exp(np.multiply(r, tau)))
+    return result(payoff - cost)
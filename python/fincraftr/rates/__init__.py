@@ -0,0 +1,24 @@
+import importlib
+
+# Fallback functions are imported from their defining module on first access (PEP 562)
+_FUNCTIONS = {
+    "compound_discrete": "compounding",
+    "compound_continuous": "compounding",
+    "nominal_to_continuous": "conversions",
+    "continuous_to_nominal": "conversions",
+    "roll_forward_cont": "discount",
+    "roll_back_cont": "discount",
+}
+
+
+def __getattr__(name):
+    module = _FUNCTIONS.get(name)
+    if module is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(f".{module}", __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(_FUNCTIONS))
@@ -1,8 +1,10 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 
 def compound_discrete(p0:float, r:float, m:int, years:float) -> float:
-    return p0 * (1 + r / m) ** (m * years)
+    return result(np.multiply(p0, np.power(1 + np.divide(r, m), np.multiply(m, years))))
 
 def compound_continuous(p0:float, r:float, t:float) -> float:
-    return p0 * math.exp(r * t)
+    return result(np.multiply(p0, np.exp(np.multiply(r, t))))
@@ -1,7 +1,9 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 def nominal_to_continuous(R: float, m: int) -> float:
-    return m * math.log(1 + R / m)
+    return result(np.multiply(m, np.log1p(np.divide(R, m))))
 
 def continuous_to_nominal(r: float, m: int) -> float:
-    return m *(math.exp(r / m)-1)
\ No newline at end of file
+    return result(np.multiply(m, np.expm1(np.divide(r, m))))
@@ -1,8 +1,10 @@
-import math
+import numpy as np
+
+from .._vectorize import result
 
 
 def roll_forward_cont(P_t:float, r:float, tau:float) -> float:
-    return P_t * math.exp(r * tau)
+    return result(np.multiply(P_t, np.exp(np.multiply(r, tau))))
 
 def roll_back_cont(P_t:float, r:float, tau:float) -> float:
-    return P_t * math.exp(-r * tau)
\ No newline at end of file
+    return result(np.multiply(P_t, np.exp(-np.multiply(r, tau))))
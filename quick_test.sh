@@ -15,6 +15,10 @@ cmake .. -DFINCRAFTR_HEADER_ONLY=ON -DCMAKE_BUILD_TYPE=Release
 cmake --build .
 echo "✅ C++ header-only build successful"
 
+echo "🧪 Running C++ tests..."
+ctest --output-on-failure
+echo "✅ C++ tests passed"
+
 cd ..
 
 # Test C++ example compilation
@@ -19,6 +19,9 @@ from setuptools import setup, Extension
 this_directory = Path(__file__).parent
 long_description = (this_directory / "README.md").read_text()
 
+# FINCRAFTR_INSTRUMENT=1 pip install . builds the instrumented extension (fincraftr.instrument)
+define_macros = [("FINCRAFTR_INSTRUMENT", "1")] if os.environ.get("FINCRAFTR_INSTRUMENT") == "1" else []
+
 # Define the extension module using standard pybind11 extension
 ext_modules = [
     Pybind11Extension(
@@ -30,6 +33,7 @@ ext_modules = [
             "cpp/include",
             pybind11.get_cmake_dir() + "/../include",
         ],
+        define_macros=define_macros,
         language="c++",
         cxx_std=20,
     ),